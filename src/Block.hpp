@@ -1,9 +1,9 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <glm/glm.hpp>
-#include <string>
-#include <map>
 
 enum class BlockType : uint8_t
 {
@@ -11,54 +11,75 @@ enum class BlockType : uint8_t
     DIRT,
     GRASS,
     STONE,
-    WATER
+    WATER,
+    COUNT // Number of block types, must stay last.
 };
 
-// A simple struct to hold the min/max UVs for one texture in the atlas.
-struct TextureCoords {
-    glm::vec2 min; // Bottom-left corner
-    glm::vec2 max; // Top-right corner
-};
+// The number of block types, for sizing tables indexed by BlockType.
+constexpr std::size_t BLOCK_TYPE_COUNT = static_cast<std::size_t>(BlockType::COUNT);
 
-struct BlockData
+// Per-type render data. One entry per cache line, so a lookup never straddles two.
+struct alignas(64) BlockData
 {
     bool isOpaque;
-    // Different faces can have different textures.
-    TextureCoords side_uvs;
-    TextureCoords top_uvs;
-    TextureCoords bottom_uvs;
+    // Different faces can have different textures, given as atlas tile indices (row * tiles per row + column).
+    uint16_t side_tile;
+    uint16_t top_tile;
+    uint16_t bottom_tile;
 };
 
 // Holds compile-time properties of blocks.
 struct BlockTypeData {
-    bool isOpaque;
+    bool isOpaque;       // Fully hides whatever is behind it; rendered in the opaque pass.
+    bool isTransparent;  // Rendered in the transparent pass.
+    bool cullsSameType;  // Faces between two blocks of this type are not drawn.
 };
 
+// Static, compile-time data about block types, indexed by BlockType.
+inline constexpr std::array<BlockTypeData, BLOCK_TYPE_COUNT> BLOCK_TYPE_DATA = {{
+    /* AIR   */ {false, false, false},
+    /* DIRT  */ {true, false, false},
+    /* GRASS */ {true, false, false},
+    /* STONE */ {true, false, false},
+    /* WATER */ {false, true, true},
+}};
+
+// Builds a bitset over BlockType (bit n = BlockType n) of the types that have the given flag set.
+constexpr uint32_t makeBlockTypeMask(bool BlockTypeData::*flag)
+{
+    uint32_t mask = 0;
+    for (std::size_t i = 0; i < BLOCK_TYPE_DATA.size(); ++i)
+    {
+        if (BLOCK_TYPE_DATA[i].*flag)
+            mask |= 1u << i;
+    }
+    return mask;
+}
+
 class Block
 {
 public:
-    // This map will be populated by the TextureManager at startup.
-    static std::map<BlockType, BlockData> block_data_map;
+    // This table will be populated by the TextureManager at startup.
+    static std::array<BlockData, BLOCK_TYPE_COUNT> block_data;
 
-    // Static, compile-time data about block types.
-    static const std::map<BlockType, BlockTypeData> blockTypeData;
-    
-    // The get method is now just a simple map lookup.
+    // Bitsets of the block types sharing a property, for queries at bit-test cost.
+    static constexpr uint32_t OPAQUE_MASK = makeBlockTypeMask(&BlockTypeData::isOpaque);
+    static constexpr uint32_t TRANSPARENT_MASK = makeBlockTypeMask(&BlockTypeData::isTransparent);
+    static constexpr uint32_t CULLS_SAME_TYPE_MASK = makeBlockTypeMask(&BlockTypeData::cullsSameType);
+
+    // Returns the render data (atlas tiles) of a block type.
     static const BlockData& get(BlockType type)
     {
-        // Using .at() will throw an exception if the type is not in the map,
-        // which helps debug if a block type was missed during initialization.
-        return block_data_map.at(type);
+        return block_data[static_cast<std::size_t>(type)];
     }
 
     // Static helper to get compile-time properties.
-    static BlockTypeData getProperties(BlockType type)
+    static constexpr const BlockTypeData& getProperties(BlockType type)
     {
-        auto it = blockTypeData.find(type);
-        if (it != blockTypeData.end()) {
-            return it->second;
-        }
-        // Default for AIR or unknown blocks
-        return { false };
+        return BLOCK_TYPE_DATA[static_cast<std::size_t>(type)];
     }
+
+    static constexpr bool isOpaque(BlockType type) { return (OPAQUE_MASK >> static_cast<uint32_t>(type)) & 1u; }
+    static constexpr bool isTransparent(BlockType type) { return (TRANSPARENT_MASK >> static_cast<uint32_t>(type)) & 1u; }
+    static constexpr bool cullsSameType(BlockType type) { return (CULLS_SAME_TYPE_MASK >> static_cast<uint32_t>(type)) & 1u; }
 };
@@ -0,0 +1,157 @@
+#include "BlockStorage.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <bit>
+
+BlockStorage::BlockStorage(BlockType fill)
+{
+    m_palette[0] = fill;
+    m_paletteSize = 1;
+    m_bitsPerBlock = 0;
+}
+
+BlockStorage::BlockStorage(const BlockType *blocks)
+{
+    // Collect the palette first so the index width is chosen once, without repacking.
+    uint8_t paletteIndexOf[256];
+    bool seen[256] = {};
+    for (int i = 0; i < Constants::CHUNK_VOL; ++i)
+    {
+        const uint8_t type = static_cast<uint8_t>(blocks[i]);
+        if (!seen[type])
+        {
+            if (m_paletteSize == m_palette.size())
+                throw std::out_of_range("BlockStorage: invalid block type in chunk data.");
+            seen[type] = true;
+            paletteIndexOf[type] = m_paletteSize;
+            m_palette[m_paletteSize++] = blocks[i];
+        }
+    }
+
+    packIndices(blocks, paletteIndexOf);
+}
+
+BlockStorage::BlockStorage(const BlockType *blocks, uint32_t presentTypes)
+{
+    // Palette entries follow the order of the set bits.
+    uint8_t paletteIndexOf[256] = {};
+    for (uint32_t remaining = presentTypes; remaining != 0; remaining &= remaining - 1)
+    {
+        const int type = std::countr_zero(remaining);
+        if (type >= static_cast<int>(BLOCK_TYPE_COUNT))
+            throw std::out_of_range("BlockStorage: invalid block type in present-types mask.");
+        paletteIndexOf[type] = m_paletteSize;
+        m_palette[m_paletteSize++] = static_cast<BlockType>(type);
+    }
+    if (m_paletteSize == 0)
+        m_paletteSize = 1; // An empty mask describes nothing; treat it as all AIR.
+
+    packIndices(blocks, paletteIndexOf);
+}
+
+// Chooses the index width for the current palette and packs every voxel's palette index.
+void BlockStorage::packIndices(const BlockType *blocks, const uint8_t *paletteIndexOf)
+{
+    m_bitsPerBlock = static_cast<uint8_t>(bitsForPaletteSize(m_paletteSize));
+    if (m_bitsPerBlock == 0)
+        return; // Uniform: the palette alone describes the chunk.
+
+    // Build each word in a register from a fixed-length inner loop, which the compiler unrolls.
+    const int perWord = 64 / m_bitsPerBlock;
+    m_words.resize(Constants::CHUNK_VOL / perWord);
+    for (size_t w = 0; w < m_words.size(); ++w)
+    {
+        const BlockType *src = blocks + w * perWord;
+        uint64_t word = 0;
+        for (int i = 0; i < perWord; ++i)
+        {
+            word |= static_cast<uint64_t>(paletteIndexOf[static_cast<uint8_t>(src[i])]) << (i * m_bitsPerBlock);
+        }
+        m_words[w] = word;
+    }
+}
+
+// Returns the smallest supported index width that can address the given number of palette entries.
+int BlockStorage::bitsForPaletteSize(int paletteSize)
+{
+    if (paletteSize <= 1)
+        return 0;
+    int bits = 1;
+    while ((1 << bits) < paletteSize)
+        bits *= 2;
+    return bits;
+}
+
+int BlockStorage::findOrAddPaletteEntry(BlockType type)
+{
+    for (int i = 0; i < m_paletteSize; ++i)
+    {
+        if (m_palette[i] == type)
+            return i;
+    }
+
+    if (m_paletteSize == m_palette.size())
+        throw std::out_of_range("BlockStorage: invalid block type.");
+
+    if (m_paletteSize + 1 > (1 << m_bitsPerBlock))
+        resizeIndices(std::max(1, m_bitsPerBlock * 2));
+    m_palette[m_paletteSize] = type;
+    return m_paletteSize++;
+}
+
+// Repacks all indices at a wider bit width.
+void BlockStorage::resizeIndices(int newBitsPerBlock)
+{
+    std::vector<uint64_t> newWords(Constants::CHUNK_VOL * newBitsPerBlock / 64, 0);
+    // Uniform storage has no indices; every voxel refers to palette entry 0.
+    if (m_bitsPerBlock > 0)
+    {
+        const uint64_t oldMask = (uint64_t{1} << m_bitsPerBlock) - 1;
+        for (int i = 0; i < Constants::CHUNK_VOL; ++i)
+        {
+            const uint32_t oldOffset = static_cast<uint32_t>(i) * m_bitsPerBlock;
+            const uint32_t newOffset = static_cast<uint32_t>(i) * newBitsPerBlock;
+            const uint64_t paletteIndex = (m_words[oldOffset >> 6] >> (oldOffset & 63)) & oldMask;
+            newWords[newOffset >> 6] |= paletteIndex << (newOffset & 63);
+        }
+    }
+    m_words = std::move(newWords);
+    m_bitsPerBlock = static_cast<uint8_t>(newBitsPerBlock);
+}
+
+void BlockStorage::set(int x, int y, int z, BlockType type)
+{
+    const uint64_t paletteIndex = static_cast<uint64_t>(findOrAddPaletteEntry(type));
+    if (m_bitsPerBlock == 0)
+        return; // Still uniform, and the type matches.
+
+    const int index = x * Constants::CHUNK_AREA + y * Constants::CHUNK_DIM + z;
+    const uint32_t bitOffset = static_cast<uint32_t>(index) * m_bitsPerBlock;
+    const uint64_t mask = (uint64_t{1} << m_bitsPerBlock) - 1;
+
+    uint64_t &word = m_words[bitOffset >> 6];
+    word = (word & ~(mask << (bitOffset & 63))) | (paletteIndex << (bitOffset & 63));
+}
+
+void BlockStorage::decode(BlockType *out) const
+{
+    if (m_bitsPerBlock == 0)
+    {
+        std::fill(out, out + Constants::CHUNK_VOL, m_palette[0]);
+        return;
+    }
+
+    const int bits = m_bitsPerBlock;
+    const int entriesPerWord = 64 / bits;
+    const uint64_t mask = (uint64_t{1} << bits) - 1;
+
+    for (size_t w = 0; w < m_words.size(); ++w)
+    {
+        uint64_t word = m_words[w];
+        for (int e = 0; e < entriesPerWord; ++e)
+        {
+            *out++ = m_palette[word & mask];
+            word >>= bits;
+        }
+    }
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "Block.hpp"
+#include "Constants.hpp"
+
+/**
+ * @class BlockStorage
+ * @brief Palette-compressed storage for the blocks of one chunk.
+ *
+ * Each distinct block type in the chunk gets a palette entry, and every voxel stores only its
+ * palette index, bit-packed at 1, 2, 4 or 8 bits per voxel. The index width grows as new types
+ * are added, so a chunk with two block types takes 512 bytes instead of 4 KiB.
+ * A uniform chunk (a single palette entry) stores no indices at all.
+ * Voxels are addressed in x-major order: index = x * CHUNK_AREA + y * CHUNK_DIM + z.
+ *
+ * Not thread-safe; readers and writers must be synchronized by the owner.
+ */
+class BlockStorage
+{
+private:
+    // The block types in use, indexed by palette index.
+    std::array<BlockType, BLOCK_TYPE_COUNT> m_palette{};
+    uint8_t m_paletteSize = 0;
+    // Bits per packed palette index (0 when uniform, else 1, 2, 4 or 8). Entries never straddle two words.
+    uint8_t m_bitsPerBlock = 0;
+    std::vector<uint64_t> m_words;
+
+    static int bitsForPaletteSize(int paletteSize);
+    int findOrAddPaletteEntry(BlockType type);
+    void packIndices(const BlockType *blocks, const uint8_t *paletteIndexOf);
+    void resizeIndices(int newBitsPerBlock);
+
+public:
+    // Creates storage filled with a single block type.
+    explicit BlockStorage(BlockType fill = BlockType::AIR);
+    // Creates storage from CHUNK_VOL block types in x-major order.
+    explicit BlockStorage(const BlockType *blocks);
+    // As above, with the set of types present already known (bit n = BlockType n), which skips the palette scan.
+    BlockStorage(const BlockType *blocks, uint32_t presentTypes);
+
+    BlockType get(int index) const
+    {
+        if (m_bitsPerBlock == 0)
+            return m_palette[0];
+        const uint32_t bitOffset = static_cast<uint32_t>(index) * m_bitsPerBlock;
+        const uint64_t mask = (uint64_t{1} << m_bitsPerBlock) - 1;
+        return m_palette[(m_words[bitOffset >> 6] >> (bitOffset & 63)) & mask];
+    }
+
+    BlockType get(int x, int y, int z) const
+    {
+        return get(x * Constants::CHUNK_AREA + y * Constants::CHUNK_DIM + z);
+    }
+
+    // Sets a block, widening the packed indices if the type is new and the palette is full.
+    void set(int x, int y, int z, BlockType type);
+
+    // Decodes all CHUNK_VOL blocks into `out` in x-major order.
+    void decode(BlockType *out) const;
+
+    // Returns true if every voxel holds the same block type.
+    bool isUniform() const { return m_bitsPerBlock == 0; }
+    int getPaletteSize() const { return m_paletteSize; }
+    int getBitsPerBlock() const { return m_bitsPerBlock; }
+};
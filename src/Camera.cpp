@@ -1,4 +1,86 @@
 #include "Camera.hpp"
+#include <algorithm>
+#include <immintrin.h>
+
+// The batched frustum test. Each SIMD path is compiled for its own target and only called when the CPU
+// supports it. A plane's normal is the same for every box, so the p-vertex is picked per plane rather than
+// per box, and the distance is summed in glm::dot's order (x + y, + z, + w) so the result matches isAABBVisible.
+
+namespace
+{
+    using Planes = std::array<glm::vec4, 6>;
+
+    // The boxes [first, last) of one 64-box mask word, tested one at a time.
+    uint64_t testBoxesScalar(const Planes &planes, const AABBArrays &boxes, size_t first, size_t last)
+    {
+        uint64_t mask = 0;
+        for (size_t i = first; i < last; ++i)
+        {
+            bool visible = true;
+            for (const glm::vec4 &plane : planes)
+            {
+                const float px = (plane.x > 0) ? boxes.maxX[i] : boxes.minX[i];
+                const float py = (plane.y > 0) ? boxes.maxY[i] : boxes.minY[i];
+                const float pz = (plane.z > 0) ? boxes.maxZ[i] : boxes.minZ[i];
+                if (plane.x * px + plane.y * py + plane.z * pz + plane.w < 0.0f)
+                {
+                    visible = false;
+                    break;
+                }
+            }
+            mask |= static_cast<uint64_t>(visible) << (i - first);
+        }
+        return mask;
+    }
+
+    __attribute__((target("sse2"))) uint64_t testBoxesSse(const Planes &planes, const AABBArrays &boxes, size_t first, size_t last)
+    {
+        uint64_t mask = 0;
+        size_t i = first;
+        for (; i + 4 <= last; i += 4)
+        {
+            const __m128 minX = _mm_loadu_ps(boxes.minX + i), maxX = _mm_loadu_ps(boxes.maxX + i);
+            const __m128 minY = _mm_loadu_ps(boxes.minY + i), maxY = _mm_loadu_ps(boxes.maxY + i);
+            const __m128 minZ = _mm_loadu_ps(boxes.minZ + i), maxZ = _mm_loadu_ps(boxes.maxZ + i);
+            __m128 visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (const glm::vec4 &plane : planes)
+            {
+                const __m128 dx = _mm_mul_ps(_mm_set1_ps(plane.x), (plane.x > 0) ? maxX : minX);
+                const __m128 dy = _mm_mul_ps(_mm_set1_ps(plane.y), (plane.y > 0) ? maxY : minY);
+                const __m128 dz = _mm_mul_ps(_mm_set1_ps(plane.z), (plane.z > 0) ? maxZ : minZ);
+                const __m128 distance = _mm_add_ps(_mm_add_ps(_mm_add_ps(dx, dy), dz), _mm_set1_ps(plane.w));
+                // Not (distance < 0), so NaNs count as visible like in the scalar test.
+                visible = _mm_and_ps(visible, _mm_cmpnlt_ps(distance, _mm_setzero_ps()));
+            }
+            mask |= static_cast<uint64_t>(_mm_movemask_ps(visible)) << (i - first);
+        }
+        return mask | (testBoxesScalar(planes, boxes, i, last) << (i - first));
+    }
+
+    __attribute__((target("avx2"))) uint64_t testBoxesAvx2(const Planes &planes, const AABBArrays &boxes, size_t first, size_t last)
+    {
+        uint64_t mask = 0;
+        size_t i = first;
+        for (; i + 8 <= last; i += 8)
+        {
+            const __m256 minX = _mm256_loadu_ps(boxes.minX + i), maxX = _mm256_loadu_ps(boxes.maxX + i);
+            const __m256 minY = _mm256_loadu_ps(boxes.minY + i), maxY = _mm256_loadu_ps(boxes.maxY + i);
+            const __m256 minZ = _mm256_loadu_ps(boxes.minZ + i), maxZ = _mm256_loadu_ps(boxes.maxZ + i);
+            __m256 visible = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+            for (const glm::vec4 &plane : planes)
+            {
+                const __m256 dx = _mm256_mul_ps(_mm256_set1_ps(plane.x), (plane.x > 0) ? maxX : minX);
+                const __m256 dy = _mm256_mul_ps(_mm256_set1_ps(plane.y), (plane.y > 0) ? maxY : minY);
+                const __m256 dz = _mm256_mul_ps(_mm256_set1_ps(plane.z), (plane.z > 0) ? maxZ : minZ);
+                const __m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(dx, dy), dz), _mm256_set1_ps(plane.w));
+                // Not (distance < 0), so NaNs count as visible like in the scalar test.
+                visible = _mm256_and_ps(visible, _mm256_cmp_ps(distance, _mm256_setzero_ps(), _CMP_NLT_UQ));
+            }
+            mask |= static_cast<uint64_t>(_mm256_movemask_ps(visible)) << (i - first);
+        }
+        return mask | (testBoxesScalar(planes, boxes, i, last) << (i - first));
+    }
+}
 
 // Constructor
 Camera::Camera(glm::vec3 position, int windowWidth, int windowHeight, glm::vec3 up, float yaw, float pitch)
@@ -10,6 +92,9 @@ Camera::Camera(glm::vec3 position, int windowWidth, int windowHeight, glm::vec3
     m_pitch = pitch;
     updateCameraVectors();
     updateProjectionMatrix(windowWidth, windowHeight);
+
+    __builtin_cpu_init();
+    m_simdPath = __builtin_cpu_supports("avx2") ? SimdPath::AVX2 : SimdPath::SSE2; // SSE2 is part of x86-64
 }
 
 // Returns the view matrix calculated using Euler Angles and the LookAt Matrix.
@@ -124,10 +209,78 @@ bool Camera::isAABBVisible(const glm::vec3 &min, const glm::vec3 &max) const
     return true; // The AABB is inside or intersects the frustum
 }
 
+// Tests a batch of Axis-Aligned Bounding Boxes against the camera's frustum, 64 boxes per mask word.
+void Camera::areAABBsVisible(const AABBArrays &boxes, size_t count, uint64_t *visibleMask) const
+{
+    for (size_t first = 0; first < count; first += 64)
+    {
+        const size_t last = std::min(first + 64, count);
+        switch (m_simdPath)
+        {
+        case SimdPath::AVX2:
+            visibleMask[first / 64] = testBoxesAvx2(m_frustumPlanes, boxes, first, last);
+            break;
+        case SimdPath::SSE2:
+            visibleMask[first / 64] = testBoxesSse(m_frustumPlanes, boxes, first, last);
+            break;
+        default:
+            visibleMask[first / 64] = testBoxesScalar(m_frustumPlanes, boxes, first, last);
+            break;
+        }
+    }
+}
+
+void Camera::setSimdPath(SimdPath path)
+{
+    m_simdPath = std::min(m_simdPath, path);
+}
+
+const char *Camera::getSimdPathName() const
+{
+    switch (m_simdPath)
+    {
+    case SimdPath::AVX2:
+        return "AVX2";
+    case SimdPath::SSE2:
+        return "SSE2";
+    default:
+        return "scalar";
+    }
+}
+
+// Classifies an Axis-Aligned Bounding Box against the camera's frustum.
+FrustumTest Camera::classifyAABB(const glm::vec3 &min, const glm::vec3 &max) const
+{
+    FrustumTest result = FrustumTest::INSIDE;
+    for (int i = 0; i < 6; ++i)
+    {
+        const glm::vec4 &plane = m_frustumPlanes[i];
+
+        // If the p-vertex (furthest along the normal) is outside, the entire AABB is outside.
+        const glm::vec3 p_vertex(
+            (plane.x > 0) ? max.x : min.x,
+            (plane.y > 0) ? max.y : min.y,
+            (plane.z > 0) ? max.z : min.z);
+        if (glm::dot(glm::vec3(plane), p_vertex) + plane.w < 0.0f)
+            return FrustumTest::OUTSIDE;
+
+        // If the n-vertex (furthest against the normal) is outside, the AABB crosses this plane.
+        const glm::vec3 n_vertex(
+            (plane.x > 0) ? min.x : max.x,
+            (plane.y > 0) ? min.y : max.y,
+            (plane.z > 0) ? min.z : max.z);
+        if (glm::dot(glm::vec3(plane), n_vertex) + plane.w < 0.0f)
+            result = FrustumTest::INTERSECTS;
+    }
+
+    return result;
+}
+
 // Getters
 const glm::vec3 &Camera::getPosition() const { return m_position; }
 const glm::vec3 &Camera::getFront() const { return m_front; }
 float Camera::getFov() const { return m_fov; }
+const std::array<glm::vec4, 6> &Camera::getFrustumPlanes() const { return m_frustumPlanes; }
 
 // Calculates the front vector from the Camera's (updated) Euler Angles.
 void Camera::updateCameraVectors()
@@ -4,6 +4,8 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <vector>
 #include <array>
+#include <cstddef>
+#include <cstdint>
 
 // Defines several possible options for camera movement.
 // Used as an abstraction to stay away from window-system specific input methods.
@@ -17,6 +19,21 @@ enum class CameraMovement
     DOWN
 };
 
+// The result of classifying a bounding box against the view frustum.
+enum class FrustumTest
+{
+    OUTSIDE,    // Entirely outside (behind at least one plane)
+    INTERSECTS, // Crossing at least one plane
+    INSIDE      // Entirely inside every plane
+};
+
+// Axis-Aligned Bounding Boxes in structure-of-arrays layout, for the batched frustum test.
+struct AABBArrays
+{
+    const float *minX, *minY, *minZ;
+    const float *maxX, *maxY, *maxZ;
+};
+
 // Default camera values
 const float YAW = -90.0f;
 const float PITCH = 0.0f;
@@ -36,6 +53,15 @@ const float FAR_PLANE = 100000.0f;
  */
 class Camera
 {
+public:
+    // The instruction set used by the batched frustum test.
+    enum class SimdPath
+    {
+        SCALAR,
+        SSE2,
+        AVX2
+    };
+
 private:
     // Camera Attributes
     glm::vec3 m_position;
@@ -54,6 +80,8 @@ private:
     glm::mat4 m_projectionMatrix;
     // Frustum planes
     std::array<glm::vec4, 6> m_frustumPlanes;
+    // The widest SIMD path the CPU supports, for areAABBsVisible.
+    SimdPath m_simdPath;
 
     // Calculates the front vector from the Camera's (updated) Euler Angles.
     void updateCameraVectors();
@@ -83,8 +111,23 @@ public:
     // Checks if an Axis-Aligned Bounding Box is visible within the camera's frustum.
     bool isAABBVisible(const glm::vec3 &min, const glm::vec3 &max) const;
 
+    // Tests `count` Axis-Aligned Bounding Boxes against the camera's frustum, 8 (AVX2) or 4 (SSE2) at a time, with
+    // exactly the result of isAABBVisible for each. Bit i % 64 of visibleMask[i / 64] is set if box i is visible;
+    // the mask must hold (count + 63) / 64 words.
+    void areAABBsVisible(const AABBArrays &boxes, size_t count, uint64_t *visibleMask) const;
+
+    // Forces a narrower SIMD path for areAABBsVisible (it can never widen the detected one).
+    void setSimdPath(SimdPath path);
+    SimdPath getSimdPath() const { return m_simdPath; }
+    const char *getSimdPathName() const;
+
+    // Classifies an Axis-Aligned Bounding Box as outside, crossing or entirely inside the camera's frustum.
+    FrustumTest classifyAABB(const glm::vec3 &min, const glm::vec3 &max) const;
+
     // Getters
     const glm::vec3 &getPosition() const;
     const glm::vec3 &getFront() const;
     float getFov() const;
+    // The frustum planes (left, right, bottom, top, near, far) as of the last updateFrustum, normals pointing inwards.
+    const std::array<glm::vec4, 6> &getFrustumPlanes() const;
 };
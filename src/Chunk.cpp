@@ -1,7 +1,9 @@
 #include "Chunk.hpp"
-#include "World.hpp"
 #include "Shader.hpp"
 #include <vector>
+#include <algorithm>
+#include <bit>
+#include <array>
 
 void Chunk::calculateAABB()
 {
@@ -13,40 +15,233 @@ void Chunk::calculateAABB()
     m_expandedAabb = {m_aabb.min - margin_vec, m_aabb.max + margin_vec};
 }
 
-Chunk::Chunk(glm::ivec3 chunkCoord, const uint32_t *gpuBlockData)
-    : m_chunkCoord(chunkCoord)
+Chunk::Chunk(glm::ivec3 chunkCoord, const BlockType *blocks, uint32_t presentTypes)
+    : m_chunkCoord(chunkCoord), m_blocks(blocks, presentTypes) // The GPU writes blocks in the same x-major order the storage uses.
 {
+    if ((presentTypes & ~Block::OPAQUE_MASK) == 0)
+        m_faceConnectivity = 0;
+    else if ((presentTypes & Block::OPAQUE_MASK) == 0)
+        m_faceConnectivity = ALL_FACES_CONNECTED;
+    else
+        m_faceConnectivity = computeFaceConnectivity(blocks);
+
     m_position = glm::vec3(m_chunkCoord) * Constants::CHUNK_WIDTH;
     m_centerPosition = m_position + (Constants::CHUNK_WIDTH / 2.0f);
     calculateAABB();
+}
 
-    for (int x = 0; x < Constants::CHUNK_DIM; ++x)
+Chunk::Chunk(glm::ivec3 chunkCoord, BlockType fill)
+    : m_chunkCoord(chunkCoord), m_blocks(fill),
+      m_faceConnectivity(Block::isOpaque(fill) ? 0 : ALL_FACES_CONNECTED)
+{
+    m_position = glm::vec3(m_chunkCoord) * Constants::CHUNK_WIDTH;
+    m_centerPosition = m_position + (Constants::CHUNK_WIDTH / 2.0f);
+    calculateAABB();
+}
+
+Chunk::~Chunk() {}
+
+// Flood-fills each group of connected non-opaque blocks that touches the boundary, and connects
+// every pair of faces the group touches. Blocks are in x-major order. The fill works on whole rows
+// along z at a time, as bitmasks: a row spreads within itself by shifts, and into the four rows next
+// to it by a single AND.
+uint16_t Chunk::computeFaceConnectivity(const BlockType *blocks)
+{
+    constexpr int DIM = Constants::CHUNK_DIM;
+    static_assert(DIM == 16, "The flood fill keeps a row of blocks along z in a uint16_t.");
+    constexpr uint16_t ROW_ENDS = 1u | (1u << (DIM - 1));
+
+    // Bit z of open[x][y] is set if the block (x, y, z) is not opaque.
+    uint16_t open[DIM][DIM];
+    for (int x = 0; x < DIM; ++x)
     {
-        for (int y = 0; y < Constants::CHUNK_DIM; ++y)
+        for (int y = 0; y < DIM; ++y)
         {
-            for (int z = 0; z < Constants::CHUNK_DIM; ++z)
+            uint16_t row = 0;
+            for (int z = 0; z < DIM; ++z)
+                row |= static_cast<uint16_t>(!Block::isOpaque(blocks[x * Constants::CHUNK_AREA + y * DIM + z])) << z;
+            open[x][y] = row;
+        }
+    }
+
+    // Grows a set of blocks within a row to the whole runs of open blocks containing them.
+    auto spread = [](uint16_t bits, uint16_t openRow)
+    {
+        for (uint16_t next = bits; ; bits = next)
+        {
+            next = (bits | static_cast<uint16_t>(bits << 1) | static_cast<uint16_t>(bits >> 1)) & openRow;
+            if (next == bits)
+                return bits;
+        }
+    };
+
+    struct RowFill
+    {
+        uint8_t x, y;
+        uint16_t bits;
+    };
+    uint16_t filled[DIM][DIM] = {};
+    std::array<RowFill, Constants::CHUNK_VOL> stack; // Every push fills at least one new block
+    uint16_t connectivity = 0;
+
+    for (int x = 0; x < DIM; ++x)
+    {
+        for (int y = 0; y < DIM; ++y)
+        {
+            // Groups not touching the boundary connect no faces; every group that does is entered from a boundary block.
+            const bool boundaryRow = x == 0 || x == DIM - 1 || y == 0 || y == DIM - 1;
+            uint16_t seeds = open[x][y] & ~filled[x][y] & (boundaryRow ? 0xFFFFu : ROW_ENDS);
+            while (seeds != 0 && connectivity != ALL_FACES_CONNECTED)
             {
-                int sourceIndex = (x * Constants::CHUNK_AREA) + (y * Constants::CHUNK_DIM) + z;
-                m_blocks[x][y][z] = static_cast<BlockType>(gpuBlockData[sourceIndex]);
+                uint8_t touchedFaces = 0;
+                int stackSize = 0;
+                const uint16_t run = spread(seeds & -seeds, open[x][y]);
+                filled[x][y] |= run;
+                stack[stackSize++] = {static_cast<uint8_t>(x), static_cast<uint8_t>(y), run};
+                while (stackSize > 0)
+                {
+                    const RowFill fill = stack[--stackSize];
+                    touchedFaces |= static_cast<uint8_t>((fill.x == 0) << 0 | (fill.x == DIM - 1) << 1 | (fill.y == 0) << 2 |
+                                                         (fill.y == DIM - 1) << 3 | (fill.bits & 1u) << 4 | (fill.bits >> (DIM - 1)) << 5);
+
+                    const int neighbours[4][2] = {{fill.x - 1, fill.y}, {fill.x + 1, fill.y}, {fill.x, fill.y - 1}, {fill.x, fill.y + 1}};
+                    for (const auto &[nx, ny] : neighbours)
+                    {
+                        if (nx < 0 || nx >= DIM || ny < 0 || ny >= DIM)
+                            continue;
+                        const uint16_t entered = fill.bits & open[nx][ny] & ~filled[nx][ny];
+                        if (entered == 0)
+                            continue;
+                        const uint16_t bits = spread(entered, open[nx][ny]);
+                        filled[nx][ny] |= bits;
+                        stack[stackSize++] = {static_cast<uint8_t>(nx), static_cast<uint8_t>(ny), bits};
+                    }
+                }
+
+                for (int faceA = 0; faceA < 6; ++faceA)
+                {
+                    for (int faceB = faceA + 1; faceB < 6; ++faceB)
+                    {
+                        if ((touchedFaces >> faceA) & (touchedFaces >> faceB) & 1u)
+                            connectivity |= static_cast<uint16_t>(1u << facePairBit(faceA, faceB));
+                    }
+                }
+                seeds &= ~filled[x][y];
             }
         }
     }
+    return connectivity;
 }
 
-Chunk::~Chunk() {}
-
 BlockType Chunk::getBlock(int x, int y, int z) const
 {
     if (x < 0 || x >= Constants::CHUNK_DIM || y < 0 || y >= Constants::CHUNK_DIM || z < 0 || z >= Constants::CHUNK_DIM)
         return BlockType::AIR;
-    return m_blocks[x][y][z];
+    return m_blocks.get(x, y, z);
+}
+
+bool Chunk::isUniform() const
+{
+    return m_blocks.isUniform();
+}
+
+bool Chunk::hasNonOpaqueBoundary(int axis, int side) const
+{
+    if (m_blocks.isUniform())
+        return !Block::isOpaque(m_blocks.get(0));
+
+    glm::ivec3 pos(0);
+    pos[axis] = (side < 0) ? 0 : Constants::CHUNK_DIM - 1;
+    for (int u = 0; u < Constants::CHUNK_DIM; ++u)
+    {
+        for (int v = 0; v < Constants::CHUNK_DIM; ++v)
+        {
+            pos[(axis + 1) % 3] = u;
+            pos[(axis + 2) % 3] = v;
+            if (!Block::isOpaque(m_blocks.get(pos.x, pos.y, pos.z)))
+                return true;
+        }
+    }
+    return false;
 }
 
-MeshResult Chunk::generateMeshStandalone(const World &world) const
+void Chunk::copyToSnapshot(ChunkSnapshot &snapshot) const
+{
+    BlockType blocks[Constants::CHUNK_VOL];
+    m_blocks.decode(blocks);
+
+    for (int x = 0; x < Constants::CHUNK_DIM; ++x)
+    {
+        for (int y = 0; y < Constants::CHUNK_DIM; ++y)
+        {
+            const BlockType *row = blocks + x * Constants::CHUNK_AREA + y * Constants::CHUNK_DIM;
+            std::copy(row, row + Constants::CHUNK_DIM, &snapshot.blocks[x + 1][y + 1][1]);
+        }
+    }
+}
+
+void Chunk::copyFaceToSnapshot(ChunkSnapshot &snapshot, int axis, int side) const
+{
+    const int u_axis = (axis + 1) % 3;
+    const int v_axis = (axis + 2) % 3;
+
+    glm::ivec3 sourcePos(0);
+    glm::ivec3 targetPos(0);
+    // The neighbour on the negative side contributes its last layer, the one on the positive side its first.
+    sourcePos[axis] = (side < 0) ? Constants::CHUNK_DIM - 1 : 0;
+    targetPos[axis] = (side < 0) ? 0 : ChunkSnapshot::DIM - 1;
+
+    for (int u = 0; u < Constants::CHUNK_DIM; ++u)
+    {
+        for (int v = 0; v < Constants::CHUNK_DIM; ++v)
+        {
+            sourcePos[u_axis] = u;
+            sourcePos[v_axis] = v;
+            targetPos[u_axis] = u + 1;
+            targetPos[v_axis] = v + 1;
+            snapshot.blocks[targetPos.x][targetPos.y][targetPos.z] = m_blocks.get(sourcePos.x, sourcePos.y, sourcePos.z);
+        }
+    }
+}
+
+// Appends one greedy quad covering `quad_height` x `quad_width` faces to the mesh.
+// `i` is the slice along axis `d`, (`j_quad`, `k_quad`) the quad's first cell along the face's u and v axes.
+static void emitQuad(MeshResult &result, BlockType type, int d, int dir, int i, int j_quad, int k_quad, int quad_height, int quad_width)
+{
+    const int u_axis = (d + 1) % 3;
+    const int v_axis = (d + 2) % 3;
+
+    const BlockData& blockData = Block::get(type);
+    std::vector<Quad> &targetQuads = Block::isOpaque(type) ? result.opaqueQuads : result.transparentQuads;
+
+    uint32_t tile; // The atlas tile of this face
+    if (d == 1) { // Y-face (up/down)
+        tile = (dir > 0) ? blockData.top_tile : blockData.bottom_tile;
+    } else { // X or Z faces
+        tile = blockData.side_tile;
+    }
+    const int face = d * 2 + (dir > 0 ? 1 : 0);
+
+    glm::ivec3 quad_start_corner_local(0);
+    quad_start_corner_local[d] = i + (dir > 0 ? 1 : 0);
+    quad_start_corner_local[u_axis] = j_quad;
+    quad_start_corner_local[v_axis] = k_quad;
+
+    // quad_height is the extent of the quad along the "u" world-axis of the face,
+    // quad_width its extent along the "v" world-axis. The vertex shader derives the corners,
+    // winding and texture repetition from these and the face.
+    targetQuads.push_back(Quad::pack(quad_start_corner_local, face, quad_height, quad_width, tile));
+}
+
+MeshResult Chunk::generateMeshStandalone(const ChunkSnapshot &snapshot, MeshingMode mode) const
+{
+    return (mode == MeshingMode::BINARY) ? generateBinaryMesh(snapshot) : generateGreedyMesh(snapshot);
+}
+
+MeshResult Chunk::generateGreedyMesh(const ChunkSnapshot &snapshot) const
 {
     MeshResult result;
     result.chunkCoord = m_chunkCoord;
-    const glm::ivec3 chunkOriginWBC = m_chunkCoord * Constants::CHUNK_DIM;
 
     for (int d = 0; d < 3; ++d) 
     {
@@ -70,27 +265,16 @@ MeshResult Chunk::generateMeshStandalone(const World &world) const
                         localPos[u_axis] = j_mask;
                         localPos[v_axis] = k_mask;
 
-                        const glm::ivec3 currentWBC = chunkOriginWBC + localPos;
-                        const glm::ivec3 neighborWBC = currentWBC + glm::ivec3(normal);
-
-                        const BlockType currentType = world.getBlock(currentWBC);
+                        const BlockType currentType = snapshot.get(localPos);
                         if (currentType == BlockType::AIR) continue;
-                        const BlockType neighborType = world.getBlock(neighborWBC);
+                        const BlockType neighborType = snapshot.get(localPos + glm::ivec3(normal));
 
-                        const BlockTypeData currentProps = Block::getProperties(currentType);
-                        const BlockTypeData neighborProps = Block::getProperties(neighborType);
-                        
-                        bool shouldDrawFace = false;
-                        if (currentProps.isOpaque) { 
-                            if (!neighborProps.isOpaque) shouldDrawFace = true; 
-                        } else { 
-                            if (neighborType == BlockType::AIR || neighborProps.isOpaque) {
-                                shouldDrawFace = true;
-                            } else if (neighborType == currentType) { 
-                                shouldDrawFace = false;
-                            } else { 
-                                shouldDrawFace = true; 
-                            }
+                        bool shouldDrawFace;
+                        if (Block::isOpaque(currentType)) {
+                            shouldDrawFace = !Block::isOpaque(neighborType);
+                        } else {
+                            // Transparent faces are only hidden by a neighbour of the same type, if the type culls itself.
+                            shouldDrawFace = !(neighborType == currentType && Block::cullsSameType(currentType));
                         }
                         if(shouldDrawFace) mask[j_mask][k_mask] = currentType;
                     }
@@ -122,109 +306,133 @@ MeshResult Chunk::generateMeshStandalone(const World &world) const
                             if (!done) quad_height++;
                         }
 
-                        const BlockData& blockData = Block::get(currentType);
-                        const BlockTypeData& blockTypeProperties = Block::getProperties(currentType);
+                        emitQuad(result, currentType, d, dir, i, j_quad, k_quad, quad_height, quad_width);
 
-                        std::vector<Vertex> &targetVertices = blockTypeProperties.isOpaque ? result.opaqueVertices : result.transparentVertices;
-                        std::vector<unsigned short> &targetIndices = blockTypeProperties.isOpaque ? result.opaqueIndices : result.transparentIndices;
-                        
-                        TextureCoords tile_atlas_uvs; // This holds {min_atlas_uv, max_atlas_uv} for the tile
-                        if (d == 1) { // Y-face (up/down)
-                            tile_atlas_uvs = (dir > 0) ? blockData.top_uvs : blockData.bottom_uvs;
-                        } else { // X or Z faces
-                            tile_atlas_uvs = blockData.side_uvs;
-                        }
+                        for (int l = 0; l < quad_height; ++l)
+                            for (int m = 0; m < quad_width; ++m)
+                                mask[j_quad + l][k_quad + m] = BlockType::AIR;
+                        k_quad += quad_width;
+                    }
+                }
+            }
+        }
+    }
+    return result;
+}
 
-                        glm::vec3 quad_start_corner_local(0);
-                        quad_start_corner_local[d] = static_cast<float>(i + (dir > 0 ? 1 : 0)); 
-                        quad_start_corner_local[u_axis] = static_cast<float>(j_quad);
-                        quad_start_corner_local[v_axis] = static_cast<float>(k_quad);
+MeshResult Chunk::generateBinaryMesh(const ChunkSnapshot &snapshot) const
+{
+    constexpr int DIM = Constants::CHUNK_DIM;
+    constexpr int TYPE_COUNT = static_cast<int>(BLOCK_TYPE_COUNT);
+    constexpr uint32_t SLICE_BITS = (1u << DIM) - 1;
 
-                        glm::vec3 du_vec(0), dv_vec(0); 
-                        du_vec[u_axis] = 1.0f;
-                        dv_vec[v_axis] = 1.0f;
+    MeshResult result;
+    result.chunkCoord = m_chunkCoord;
 
-                        glm::vec3 p0 = quad_start_corner_local;
-                        glm::vec3 p1 = quad_start_corner_local + (static_cast<float>(quad_height) * du_vec);
-                        glm::vec3 p2 = quad_start_corner_local + (static_cast<float>(quad_height) * du_vec) + (static_cast<float>(quad_width) * dv_vec);
-                        glm::vec3 p3 = quad_start_corner_local + (static_cast<float>(quad_width) * dv_vec);
-                        
-                        unsigned short baseIndex = static_cast<unsigned short>(targetVertices.size());
+    // columns[d][type][u][v] has bit p set if the voxel at padded coordinate p along axis d
+    // (u and v being the chunk-local coordinates on the other two axes) is of that type.
+    // Bits 0 and DIM + 1 come from the neighbouring chunks, bits 1..DIM from this chunk.
+    uint32_t columns[3][TYPE_COUNT][DIM][DIM] = {};
+    uint32_t interiorTypes = 0;
 
-                        Vertex vert_template;
-                        vert_template.normal[0] = static_cast<int8_t>(normal.x);
-                        vert_template.normal[1] = static_cast<int8_t>(normal.y);
-                        vert_template.normal[2] = static_cast<int8_t>(normal.z);
-                        vert_template.color[0] = 255; vert_template.color[1] = 255; vert_template.color[2] = 255; vert_template.color[3] = 255;
-                        
-                        // Set the atlasOffset (Tx, Ty) for all vertices of this quad
-                        // This is the top-left UV coord of the tile within the atlas.
-                        vert_template.atlasOffset = tile_atlas_uvs.min;
+    for (int px = 0; px < ChunkSnapshot::DIM; ++px)
+    {
+        for (int py = 0; py < ChunkSnapshot::DIM; ++py)
+        {
+            for (int pz = 0; pz < ChunkSnapshot::DIM; ++pz)
+            {
+                const BlockType type = snapshot.blocks[px][py][pz];
+                if (type == BlockType::AIR) continue;
 
-                        glm::vec2 surface_coords[4];
-                        
-                        // quad_height is the extent of the quad along the "u" world-axis of the face
-                        // quad_width is the extent of the quad along the "v" world-axis of the face
-                        float u_extent = static_cast<float>(quad_height);
-                        float v_extent = static_cast<float>(quad_width);
-
-                        // Standard UV mapping for quads: (0,0) (1,0) (1,1) (0,1) for TL, TR, BR, BL if U is width and V is height
-                        // Our surfaceCoords represent repetition factors (how many times texture repeats)
-                        // The orientation of these repetitions depends on the face direction (d) and how du_vec, dv_vec are defined.
-                        
-                        // For d=0 (X-face), u_axis=Y, v_axis=Z. p0->p1 is along Y (+u_extent), p0->p3 is along Z (+v_extent)
-                        // Surface coords: (v, u) -> (width, height) in texture terms typically.
-                        // p0: (0,0)
-                        // p1: (0, u_extent)  -- along Y
-                        // p2: (v_extent, u_extent) -- along Y then Z
-                        // p3: (v_extent, 0)  -- along Z
-                        surface_coords[0] = glm::vec2(0.0f, 0.0f);
-                        surface_coords[1] = glm::vec2(0.0f, u_extent);
-                        surface_coords[2] = glm::vec2(v_extent, u_extent);
-                        surface_coords[3] = glm::vec2(v_extent, 0.0f);
-                        
-                        // For d=1 (Y-face), u_axis=Z, v_axis=X. p0->p1 is along Z (+u_extent), p0->p3 is along X (+v_extent)
-                        // Similar mapping to X-face.
-                        if (d == 1) { // Y-faces (top/bottom)
-                            // Surface coords typically (width, depth) or (x, z)
-                            // p0: (0,0)
-                            // p1: (0, u_extent) -- along Z
-                            // p2: (v_extent, u_extent) -- along Z then X
-                            // p3: (v_extent, 0) -- along X
-                             surface_coords[0] = glm::vec2(0.0f, 0.0f);
-                             surface_coords[1] = glm::vec2(0.0f, u_extent); // u_extent is quad_height (along Z)
-                             surface_coords[2] = glm::vec2(v_extent, u_extent); // v_extent is quad_width (along X)
-                             surface_coords[3] = glm::vec2(v_extent, 0.0f);
-                        }
+                const int t = static_cast<int>(type);
+                const int p[3] = {px, py, pz};
+                bool isInterior = true;
+                for (int d = 0; d < 3; ++d)
+                {
+                    const int u = p[(d + 1) % 3] - 1;
+                    const int v = p[(d + 2) % 3] - 1;
+                    if (u >= 0 && u < DIM && v >= 0 && v < DIM)
+                        columns[d][t][u][v] |= 1u << p[d];
+                    if (p[d] == 0 || p[d] == DIM + 1)
+                        isInterior = false;
+                }
+                if (isInterior) interiorTypes |= 1u << t;
+            }
+        }
+    }
 
-                        // For d=2 (Z-face), u_axis=X, v_axis=Y. p0->p1 is along X (+u_extent), p0->p3 is along Y (+v_extent)
-                        // p0: (0,0)
-                        // p1: (u_extent, 0) -- along X
-                        // p2: (u_extent, v_extent) -- along X then Y
-                        // p3: (0, v_extent) -- along Y
-                        if (d == 2) {
-                             surface_coords[0] = glm::vec2(0.0f, 0.0f);
-                             surface_coords[1] = glm::vec2(u_extent, 0.0f);
-                             surface_coords[2] = glm::vec2(u_extent, v_extent);
-                             surface_coords[3] = glm::vec2(0.0f, v_extent);
-                        }
+    for (int d = 0; d < 3; ++d)
+    {
+        // Opaque blocks cull the faces of every block type.
+        uint32_t opaque[DIM][DIM] = {};
+        for (int t = 0; t < TYPE_COUNT; ++t)
+        {
+            if (!(Block::OPAQUE_MASK & (1u << t))) continue;
+            for (int u = 0; u < DIM; ++u)
+                for (int v = 0; v < DIM; ++v)
+                    opaque[u][v] |= columns[d][t][u][v];
+        }
+
+        for (int dir = -1; dir <= 1; dir += 2)
+        {
+            // planes[type][i][u] has bit v set if the face at (i, u, v) of that type is visible.
+            uint16_t planes[TYPE_COUNT][DIM][DIM] = {};
 
+            for (int t = 0; t < TYPE_COUNT; ++t)
+            {
+                if (!(interiorTypes & (1u << t))) continue;
+                // Transparent blocks can only cull faces against their own type.
+                const bool isOpaque = Block::OPAQUE_MASK & (1u << t);
+                const bool cullsSameType = Block::CULLS_SAME_TYPE_MASK & (1u << t);
 
-                        vert_template.position = p0; vert_template.surfaceCoords = surface_coords[0]; targetVertices.push_back(vert_template);
-                        vert_template.position = p1; vert_template.surfaceCoords = surface_coords[1]; targetVertices.push_back(vert_template);
-                        vert_template.position = p2; vert_template.surfaceCoords = surface_coords[2]; targetVertices.push_back(vert_template);
-                        vert_template.position = p3; vert_template.surfaceCoords = surface_coords[3]; targetVertices.push_back(vert_template);
-                        
-                        if (dir > 0) { // Positive face normal
-                            targetIndices.insert(targetIndices.end(), {baseIndex, (unsigned short)(baseIndex + 1), (unsigned short)(baseIndex + 2), baseIndex, (unsigned short)(baseIndex + 2), (unsigned short)(baseIndex + 3)});
-                        } else { // Negative face normal (flipped winding)
-                            targetIndices.insert(targetIndices.end(), {baseIndex, (unsigned short)(baseIndex + 2), (unsigned short)(baseIndex + 1), baseIndex, (unsigned short)(baseIndex + 3), (unsigned short)(baseIndex + 2)});
+                for (int u = 0; u < DIM; ++u)
+                {
+                    for (int v = 0; v < DIM; ++v)
+                    {
+                        const uint32_t column = columns[d][t][u][v];
+                        if (!column) continue;
+
+                        const uint32_t culling = isOpaque ? opaque[u][v] : (cullsSameType ? column : 0u);
+                        uint32_t faces = column & ~((dir > 0) ? (culling >> 1) : (culling << 1));
+                        faces = (faces >> 1) & SLICE_BITS;
+                        while (faces)
+                        {
+                            planes[t][std::countr_zero(faces)][u] |= static_cast<uint16_t>(1u << v);
+                            faces &= faces - 1;
                         }
+                    }
+                }
+            }
 
-                        for (int l = 0; l < quad_height; ++l)
-                            for (int m = 0; m < quad_width; ++m)
-                                mask[j_quad + l][k_quad + m] = BlockType::AIR;
-                        k_quad += quad_width;
+            // Greedily merge each plane: runs along v are found with ctz, then grown along u
+            // for as long as the following rows contain the whole run.
+            for (int t = 0; t < TYPE_COUNT; ++t)
+            {
+                if (!(interiorTypes & (1u << t))) continue;
+                const BlockType type = static_cast<BlockType>(t);
+
+                for (int i = 0; i < DIM; ++i)
+                {
+                    uint16_t *plane = planes[t][i];
+                    for (int j_quad = 0; j_quad < DIM; ++j_quad)
+                    {
+                        uint32_t row = plane[j_quad];
+                        while (row)
+                        {
+                            const int k_quad = std::countr_zero(row);
+                            const int quad_width = std::countr_one(row >> k_quad);
+                            const uint32_t run = ((1u << quad_width) - 1) << k_quad;
+
+                            int quad_height = 1;
+                            while (j_quad + quad_height < DIM && (plane[j_quad + quad_height] & run) == run)
+                            {
+                                plane[j_quad + quad_height] &= static_cast<uint16_t>(~run);
+                                quad_height++;
+                            }
+
+                            emitQuad(result, type, d, dir, i, j_quad, k_quad, quad_height, quad_width);
+                            row &= ~run;
+                        }
                     }
                 }
             }
@@ -238,5 +446,6 @@ void Chunk::setTransparentMeshAllocation(MeshAllocation allocation) { m_transpar
 const glm::vec3 &Chunk::getPosition() const { return m_position; }
 const glm::vec3 &Chunk::getCenterPosition() const { return m_centerPosition; }
 const AABB &Chunk::getExpandedAABB() const { return m_expandedAabb; }
+const glm::ivec3 &Chunk::getChunkCoord() const { return m_chunkCoord; }
 const MeshAllocation &Chunk::getOpaqueMeshAllocation() const { return m_opaqueMeshAllocation; }
 const MeshAllocation &Chunk::getTransparentMeshAllocation() const { return m_transparentMeshAllocation; }
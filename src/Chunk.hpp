@@ -3,20 +3,36 @@
 #include <vector>
 #include <glm/glm.hpp>
 #include <memory>
+#include <utility>
 #include "Constants.hpp"
-#include "Vertex.hpp"
+#include "Quad.hpp"
 #include "Block.hpp"
+#include "BlockStorage.hpp"
 #include "MeshAllocation.hpp"
 
-class World; // Forward-declaration
-
 // The result from a CPU meshing worker thread.
 struct MeshResult {
     glm::ivec3 chunkCoord;
-    std::vector<Vertex> opaqueVertices;
-    std::vector<unsigned short> opaqueIndices;
-    std::vector<Vertex> transparentVertices;
-    std::vector<unsigned short> transparentIndices;
+    std::vector<Quad> opaqueQuads;
+    std::vector<Quad> transparentQuads;
+};
+
+// Selects the algorithm used to build chunk meshes. Both produce the same set of quads.
+enum class MeshingMode {
+    GREEDY,     // Scalar greedy meshing over per-slice block type masks.
+    BINARY      // Greedy meshing over per-type occupancy bitmasks, using shifts and bit scans.
+};
+
+// An immutable copy of a chunk's blocks plus a one-voxel border copied from its six face neighbours.
+// The mesher reads exclusively from this, so it never has to query the world (or take its lock).
+struct ChunkSnapshot {
+    static constexpr int DIM = Constants::CHUNK_DIM + 2;
+    // Indexed by local position + 1. Edge and corner cells of the border are always AIR.
+    BlockType blocks[DIM][DIM][DIM];
+
+    // Returns the block at a local position, where each axis may range from -1 to CHUNK_DIM.
+    BlockType get(int x, int y, int z) const { return blocks[x + 1][y + 1][z + 1]; }
+    BlockType get(const glm::ivec3 &localPos) const { return get(localPos.x, localPos.y, localPos.z); }
 };
 
 // Represents an Axis-Aligned Bounding Box.
@@ -33,35 +49,92 @@ private:
     // The world-space coordinate of the chunk's center. Used for distance sorting.
     glm::vec3 m_centerPosition;
     glm::ivec3 m_chunkCoord;
-    BlockType m_blocks[Constants::CHUNK_DIM][Constants::CHUNK_DIM][Constants::CHUNK_DIM];
+    BlockStorage m_blocks;
     MeshAllocation m_opaqueMeshAllocation;
     MeshAllocation m_transparentMeshAllocation;
     AABB m_aabb;
     AABB m_expandedAabb;
+    // Which pairs of faces are connected through non-opaque blocks, see areFacesConnected().
+    uint16_t m_faceConnectivity;
 
     void calculateAABB();
+    static uint16_t computeFaceConnectivity(const BlockType *blocks);
+
+    MeshResult generateGreedyMesh(const ChunkSnapshot &snapshot) const;
+    MeshResult generateBinaryMesh(const ChunkSnapshot &snapshot) const;
 
 
 public:
-    Chunk(glm::ivec3 chunkCoord, const uint32_t *gpuBlockData);
+    // Creates a chunk from CHUNK_VOL block types in x-major order, as generated on the GPU,
+    // together with the bitset of the types present in it.
+    Chunk(glm::ivec3 chunkCoord, const BlockType *blocks, uint32_t presentTypes);
+    // Creates a uniform chunk, filled entirely with one block type. It stores no per-voxel data.
+    Chunk(glm::ivec3 chunkCoord, BlockType fill);
     ~Chunk();
 
     BlockType getBlock(int x, int y, int z) const;
 
+    // Returns true if the whole chunk is a single block type.
+    bool isUniform() const;
+
+    // The connectivity mask with every pair of faces connected, as for an all-air chunk.
+    static constexpr uint16_t ALL_FACES_CONNECTED = 0x7FFF;
+
+    /**
+     * @brief Returns the bit of a pair of faces in the face connectivity mask.
+     * @details Faces are numbered axis * 2 + (0 for the negative side, 1 for the positive side), as
+     *          in World::buildSnapshot. The 15 unordered pairs take bits 0 to 14, ordered by (faceA, faceB).
+     */
+    static constexpr int facePairBit(int faceA, int faceB)
+    {
+        if (faceA > faceB)
+            std::swap(faceA, faceB);
+        return faceA * 6 - faceA * (faceA + 1) / 2 + (faceB - faceA - 1);
+    }
+
+    /**
+     * @brief Checks whether a path of non-opaque blocks inside the chunk links two of its faces,
+     *        i.e. whether the chunk could be seen through when entering by one and leaving by the other.
+     * @details Computed once by a flood fill when the chunk is created, since its blocks never change.
+     */
+    bool areFacesConnected(int faceA, int faceB) const { return (m_faceConnectivity >> facePairBit(faceA, faceB)) & 1u; }
+    uint16_t getFaceConnectivity() const { return m_faceConnectivity; }
+
+    /**
+     * @brief Checks whether a boundary layer contains any non-opaque block, i.e. whether the
+     *        neighbour on that side could have a visible face against this chunk.
+     * @param axis The axis (0 = X, 1 = Y, 2 = Z) of the boundary.
+     * @param side -1 for the layer at coordinate 0, +1 for the layer at CHUNK_DIM - 1.
+     */
+    bool hasNonOpaqueBoundary(int axis, int side) const;
+
+    // Copies all of this chunk's blocks into the interior of a snapshot.
+    void copyToSnapshot(ChunkSnapshot &snapshot) const;
+
+    /**
+     * @brief Copies one of this chunk's boundary layers into the border of a neighbour's snapshot.
+     * @param snapshot The neighbour's snapshot.
+     * @param axis The axis (0 = X, 1 = Y, 2 = Z) along which this chunk neighbours the snapshot's chunk.
+     * @param side -1 if this chunk lies on the negative side of the snapshot's chunk, +1 if on the positive side.
+     */
+    void copyFaceToSnapshot(ChunkSnapshot &snapshot, int axis, int side) const;
+
     /**
      * @brief Generates the chunk's mesh using a greedy meshing algorithm.
-     * @details This method iterates through the chunk's blocks and adjacent chunks
+     * @details This method iterates through a snapshot of the chunk's blocks and their neighbours
      *          to build an optimized mesh, merging adjacent faces of the same block type
      *          into larger quads. It separates opaque and transparent geometry.
-     * @param world A const reference to the world, used to check neighbor blocks.
-     * @return A MeshResult struct containing the vertex and index data for the mesh.
+     * @param snapshot A padded copy of this chunk's blocks, see World::buildSnapshot.
+     * @param mode The meshing algorithm to use.
+     * @return A MeshResult struct containing the opaque and transparent quads of the mesh.
      */
-    MeshResult generateMeshStandalone(const World &world) const;
+    MeshResult generateMeshStandalone(const ChunkSnapshot &snapshot, MeshingMode mode = MeshingMode::GREEDY) const;
 
     void setOpaqueMeshAllocation(MeshAllocation allocation);
     void setTransparentMeshAllocation(MeshAllocation allocation);
 
     // Getters
+    const glm::ivec3 &getChunkCoord() const;
     const glm::vec3 &getPosition() const;
     const glm::vec3 &getCenterPosition() const;
     const AABB &getExpandedAABB() const;
@@ -0,0 +1,63 @@
+#include "ChunkGrid.hpp"
+#include "Chunk.hpp"
+
+#include <utility>
+
+ChunkGrid::ChunkGrid(int retainRadius)
+    : m_dim(2 * retainRadius + 1),
+      m_slots(static_cast<size_t>(m_dim) * m_dim * m_dim)
+{
+}
+
+size_t ChunkGrid::slotIndex(const glm::ivec3 &coord) const
+{
+    // Non-negative modulo so negative coordinates wrap around like positive ones.
+    auto wrap = [this](int c) { return static_cast<size_t>(((c % m_dim) + m_dim) % m_dim); };
+    return (wrap(coord.x) * m_dim + wrap(coord.y)) * m_dim + wrap(coord.z);
+}
+
+ChunkGrid::Entry *ChunkGrid::slotHolds(const glm::ivec3 &coord)
+{
+    Entry &entry = m_slots[slotIndex(coord)];
+    return entry.key == ChunkMap::packCoord(coord) ? &entry : nullptr;
+}
+
+ChunkGrid::Entry &ChunkGrid::findOrInsert(const glm::ivec3 &coord)
+{
+    const uint64_t key = ChunkMap::packCoord(coord);
+    Entry &entry = m_slots[slotIndex(coord)];
+    if (entry.key == key)
+    {
+        return entry;
+    }
+
+    if (entry.key == EMPTY_KEY)
+    {
+        m_size++;
+    }
+    else if (entry.chunk)
+    {
+        m_evicted.push_back(std::move(entry.chunk));
+    }
+
+    entry = Entry{};
+    entry.key = key;
+    return entry;
+}
+
+bool ChunkGrid::erase(const glm::ivec3 &coord)
+{
+    Entry *entry = slotHolds(coord);
+    if (!entry)
+    {
+        return false;
+    }
+    *entry = Entry{};
+    m_size--;
+    return true;
+}
+
+std::vector<std::shared_ptr<Chunk>> ChunkGrid::takeEvicted()
+{
+    return std::exchange(m_evicted, {});
+}
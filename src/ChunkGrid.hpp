@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "ChunkMap.hpp"
+#include "Constants.hpp"
+
+/**
+ * @class ChunkGrid
+ * @brief A fixed 3D ring buffer of chunk entries, indexed by chunk coordinate modulo the grid size.
+ *
+ * The grid is 2 * retainRadius + 1 slots along each axis, so every coordinate within
+ * retainRadius of the player maps to its own slot and lookups are pure array indexing.
+ * Each slot remembers which coordinate it holds; claiming a slot for a new coordinate evicts
+ * the previous occupant, which makes unloading implicit. Evicted chunks are collected until
+ * takeEvicted() so their GPU meshes can be freed on the render thread.
+ *
+ * Exposes the same interface as ChunkMap. Not thread-safe.
+ */
+class ChunkGrid
+{
+public:
+    using Entry = ChunkMap::Entry;
+
+    // Grid coordinates make unloading implicit, so World skips its unload scan for this store.
+    static constexpr bool IMPLICIT_UNLOAD = true;
+
+    explicit ChunkGrid(int retainRadius = Constants::RENDER_DISTANCE + Constants::CHUNK_UNLOAD_MARGIN);
+
+    // Returns the entry for a coordinate, or nullptr if its slot holds a different coordinate.
+    Entry *find(const glm::ivec3 &coord) { return slotHolds(coord); }
+    const Entry *find(const glm::ivec3 &coord) const { return const_cast<ChunkGrid *>(this)->slotHolds(coord); }
+
+    // Returns the chunk at a coordinate, or nullptr if it has no block data (yet).
+    std::shared_ptr<Chunk> findChunk(const glm::ivec3 &coord) const
+    {
+        const Entry *entry = find(coord);
+        return entry ? entry->chunk : nullptr;
+    }
+
+    // Returns the entry for a coordinate, evicting whatever else occupied its slot.
+    Entry &findOrInsert(const glm::ivec3 &coord);
+
+    // Clears the slot for a coordinate. Returns false if the slot held something else.
+    bool erase(const glm::ivec3 &coord);
+
+    size_t size() const { return m_size; }
+
+    // Calls fn(Entry&) for every occupied slot. This can include chunks that have drifted
+    // out of range but whose slots have not been reclaimed yet.
+    template <typename Fn>
+    void forEach(Fn &&fn)
+    {
+        for (Entry &entry : m_slots)
+            if (entry.key != EMPTY_KEY)
+                fn(entry);
+    }
+
+    template <typename Fn>
+    void forEach(Fn &&fn) const
+    {
+        for (const Entry &entry : m_slots)
+            if (entry.key != EMPTY_KEY)
+                fn(entry);
+    }
+
+    // Returns the chunks evicted since the last call.
+    std::vector<std::shared_ptr<Chunk>> takeEvicted();
+
+private:
+    static constexpr uint64_t EMPTY_KEY = ~uint64_t{0};
+
+    int m_dim;
+    std::vector<Entry> m_slots;
+    std::vector<std::shared_ptr<Chunk>> m_evicted;
+    size_t m_size = 0;
+
+    size_t slotIndex(const glm::ivec3 &coord) const;
+    Entry *slotHolds(const glm::ivec3 &coord);
+};
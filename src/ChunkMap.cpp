@@ -0,0 +1,144 @@
+#include "ChunkMap.hpp"
+#include "Chunk.hpp"
+
+namespace
+{
+    constexpr int COORD_BITS = 21;
+    constexpr uint64_t COORD_MASK = (uint64_t{1} << COORD_BITS) - 1;
+}
+
+ChunkMap::ChunkMap()
+    : m_slots(INITIAL_CAPACITY), m_mask(INITIAL_CAPACITY - 1)
+{
+}
+
+// Packs each axis as a 21-bit two's complement value, covering +-1M chunks per axis.
+uint64_t ChunkMap::packCoord(const glm::ivec3 &coord)
+{
+    return ((static_cast<uint64_t>(coord.x) & COORD_MASK) << (2 * COORD_BITS)) |
+           ((static_cast<uint64_t>(coord.y) & COORD_MASK) << COORD_BITS) |
+           (static_cast<uint64_t>(coord.z) & COORD_MASK);
+}
+
+glm::ivec3 ChunkMap::unpackCoord(uint64_t key)
+{
+    // Shift each field to the top of a signed 64-bit value and back down to sign-extend it.
+    auto unpack = [](uint64_t field) {
+        return static_cast<int>(static_cast<int64_t>(field << (64 - COORD_BITS)) >> (64 - COORD_BITS));
+    };
+    return glm::ivec3(unpack((key >> (2 * COORD_BITS)) & COORD_MASK),
+                      unpack((key >> COORD_BITS) & COORD_MASK),
+                      unpack(key & COORD_MASK));
+}
+
+// The splitmix64 finalizer: every input bit affects every output bit.
+uint64_t ChunkMap::hash(uint64_t key)
+{
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ull;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebull;
+    key ^= key >> 31;
+    return key;
+}
+
+// Returns the slot holding `key`, or the empty slot where it would be inserted.
+size_t ChunkMap::findSlot(uint64_t key) const
+{
+    size_t slot = hash(key) & m_mask;
+    while (m_slots[slot].key != key && m_slots[slot].key != EMPTY_KEY)
+    {
+        slot = (slot + 1) & m_mask;
+    }
+    return slot;
+}
+
+ChunkMap::Entry *ChunkMap::find(const glm::ivec3 &coord)
+{
+    const uint64_t key = packCoord(coord);
+    Entry &entry = m_slots[findSlot(key)];
+    return entry.key == key ? &entry : nullptr;
+}
+
+const ChunkMap::Entry *ChunkMap::find(const glm::ivec3 &coord) const
+{
+    const uint64_t key = packCoord(coord);
+    const Entry &entry = m_slots[findSlot(key)];
+    return entry.key == key ? &entry : nullptr;
+}
+
+std::shared_ptr<Chunk> ChunkMap::findChunk(const glm::ivec3 &coord) const
+{
+    const Entry *entry = find(coord);
+    return entry ? entry->chunk : nullptr;
+}
+
+ChunkMap::Entry &ChunkMap::findOrInsert(const glm::ivec3 &coord)
+{
+    const uint64_t key = packCoord(coord);
+    size_t slot = findSlot(key);
+    if (m_slots[slot].key == key)
+    {
+        return m_slots[slot];
+    }
+
+    // Keep the load factor below 0.7 so probe sequences stay short.
+    if ((m_size + 1) * 10 > m_slots.size() * 7)
+    {
+        grow();
+        slot = findSlot(key);
+    }
+
+    m_slots[slot].key = key;
+    m_size++;
+    return m_slots[slot];
+}
+
+bool ChunkMap::erase(const glm::ivec3 &coord)
+{
+    const uint64_t key = packCoord(coord);
+    size_t hole = findSlot(key);
+    if (m_slots[hole].key != key)
+    {
+        return false;
+    }
+
+    // Backward-shift deletion: pull later entries of the probe run into the hole unless
+    // their home slot lies cyclically within (hole, current], where they already belong.
+    size_t current = hole;
+    while (true)
+    {
+        current = (current + 1) & m_mask;
+        if (m_slots[current].key == EMPTY_KEY)
+            break;
+
+        const size_t home = hash(m_slots[current].key) & m_mask;
+        const bool inPlace = (hole <= current) ? (hole < home && home <= current)
+                                               : (hole < home || home <= current);
+        if (!inPlace)
+        {
+            m_slots[hole] = std::move(m_slots[current]);
+            hole = current;
+        }
+    }
+
+    m_slots[hole] = Entry{};
+    m_size--;
+    return true;
+}
+
+// Doubles the table size and reinserts every entry.
+void ChunkMap::grow()
+{
+    std::vector<Entry> oldSlots = std::move(m_slots);
+    m_slots = std::vector<Entry>(oldSlots.size() * 2);
+    m_mask = m_slots.size() - 1;
+
+    for (Entry &entry : oldSlots)
+    {
+        if (entry.key != EMPTY_KEY)
+        {
+            m_slots[findSlot(entry.key)] = std::move(entry);
+        }
+    }
+}
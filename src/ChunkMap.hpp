@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+
+class Chunk;
+
+// The lifecycle state of a chunk.
+enum class ChunkState {
+    UNDEFINED,            // Not yet processed, or unloaded
+    BACKLOG,              // In the queue for GPU generation
+    GENERATING,           // Being generated, by a GPU compute job or on a worker thread
+    READBACK_PENDING,     // Copy to the readback ring scheduled, or being turned into a Chunk
+    DATA_READY,           // Data is ready, needs meshing
+    MESH_PENDING,         // Sent to CPU worker for meshing
+    READY                 // Meshed and ready to be rendered
+};
+
+/**
+ * @class ChunkMap
+ * @brief A flat open-addressing hash table from chunk coordinate to the chunk and its lifecycle state.
+ *
+ * Keys are chunk coordinates packed into 64 bits (21 bits per axis) and mixed with a splitmix64
+ * finalizer. Collisions are resolved by linear probing in a power-of-two table, and erase uses
+ * backward-shift deletion so the table never accumulates tombstones.
+ *
+ * Not thread-safe. Pointers to entries are invalidated by findOrInsert and erase.
+ */
+class ChunkMap
+{
+public:
+    struct Entry
+    {
+        uint64_t key = EMPTY_KEY;
+        // Null until the chunk's block data has been generated.
+        std::shared_ptr<Chunk> chunk;
+        ChunkState state = ChunkState::UNDEFINED;
+
+        glm::ivec3 coord() const { return unpackCoord(key); }
+    };
+
+    // Chunks stay until erased, so World has to scan for and unload out-of-range ones itself.
+    static constexpr bool IMPLICIT_UNLOAD = false;
+
+    ChunkMap();
+
+    // Returns the entry for a coordinate, or nullptr if there is none.
+    Entry *find(const glm::ivec3 &coord);
+    const Entry *find(const glm::ivec3 &coord) const;
+
+    // Returns the chunk at a coordinate, or nullptr if it has no block data (yet).
+    std::shared_ptr<Chunk> findChunk(const glm::ivec3 &coord) const;
+
+    // Returns the entry for a coordinate, creating an UNDEFINED one without a chunk if needed.
+    Entry &findOrInsert(const glm::ivec3 &coord);
+
+    // Removes the entry for a coordinate. Returns false if there was none.
+    bool erase(const glm::ivec3 &coord);
+
+    size_t size() const { return m_size; }
+
+    // The map never evicts on its own; present for interface parity with ChunkGrid.
+    std::vector<std::shared_ptr<Chunk>> takeEvicted() { return {}; }
+
+    // Calls fn(Entry&) for every entry, in table order.
+    template <typename Fn>
+    void forEach(Fn &&fn)
+    {
+        for (Entry &entry : m_slots)
+            if (entry.key != EMPTY_KEY)
+                fn(entry);
+    }
+
+    template <typename Fn>
+    void forEach(Fn &&fn) const
+    {
+        for (const Entry &entry : m_slots)
+            if (entry.key != EMPTY_KEY)
+                fn(entry);
+    }
+
+    static uint64_t packCoord(const glm::ivec3 &coord);
+    static glm::ivec3 unpackCoord(uint64_t key);
+
+private:
+    // Packed keys use 63 bits, so an all-ones key can never collide with a real coordinate.
+    static constexpr uint64_t EMPTY_KEY = ~uint64_t{0};
+    static constexpr size_t INITIAL_CAPACITY = 1024;
+
+    std::vector<Entry> m_slots;
+    size_t m_mask = 0;
+    size_t m_size = 0;
+
+    static uint64_t hash(uint64_t key);
+    size_t findSlot(uint64_t key) const;
+    void grow();
+};
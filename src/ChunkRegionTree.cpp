@@ -0,0 +1,151 @@
+#include "ChunkRegionTree.hpp"
+#include "ChunkMap.hpp"
+#include <bit>
+
+void ChunkRegionTree::growBounds(AABB &bounds, bool wasEmpty, const AABB &childBounds)
+{
+    if (wasEmpty)
+    {
+        bounds = childBounds;
+        return;
+    }
+    bounds.min = glm::min(bounds.min, childBounds.min);
+    bounds.max = glm::max(bounds.max, childBounds.max);
+}
+
+void ChunkRegionTree::insert(const std::shared_ptr<Chunk> &chunk)
+{
+    const glm::ivec3 chunkCoord = chunk->getChunkCoord();
+    const glm::ivec3 regionCoord = parentCoord(chunkCoord);
+    const glm::ivec3 superCoord = parentCoord(regionCoord);
+
+    std::unique_ptr<SuperRegion> &superRegion = m_superRegions[ChunkMap::packCoord(superCoord)];
+    if (!superRegion)
+        superRegion = std::make_unique<SuperRegion>();
+
+    const int regionIndex = childIndex(regionCoord);
+    std::unique_ptr<Region> &region = superRegion->regions[regionIndex];
+    if (!region)
+        region = std::make_unique<Region>();
+
+    const int chunkIndex = childIndex(chunkCoord);
+    const uint64_t chunkBit = uint64_t{1} << chunkIndex;
+    const bool regionWasEmpty = region->occupied == 0;
+    if (!(region->occupied & chunkBit))
+        ++m_size;
+    region->chunks[chunkIndex] = chunk;
+    region->occupied |= chunkBit;
+
+    // A chunk's bounds only depend on its coordinate, so a replaced chunk leaves them unchanged.
+    const AABB &chunkBounds = chunk->getExpandedAABB();
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        region->chunkBounds[axis][chunkIndex] = chunkBounds.min[axis];
+        region->chunkBounds[3 + axis][chunkIndex] = chunkBounds.max[axis];
+    }
+    growBounds(region->bounds, regionWasEmpty, chunkBounds);
+    growBounds(superRegion->bounds, superRegion->occupied == 0, chunkBounds);
+    superRegion->occupied |= uint64_t{1} << regionIndex;
+}
+
+void ChunkRegionTree::remove(const std::shared_ptr<Chunk> &chunk)
+{
+    const glm::ivec3 chunkCoord = chunk->getChunkCoord();
+    const glm::ivec3 regionCoord = parentCoord(chunkCoord);
+    const glm::ivec3 superCoord = parentCoord(regionCoord);
+
+    auto it = m_superRegions.find(ChunkMap::packCoord(superCoord));
+    if (it == m_superRegions.end())
+        return;
+    SuperRegion &superRegion = *it->second;
+
+    const int regionIndex = childIndex(regionCoord);
+    std::unique_ptr<Region> &region = superRegion.regions[regionIndex];
+    if (!region)
+        return;
+
+    const int chunkIndex = childIndex(chunkCoord);
+    if (region->chunks[chunkIndex] != chunk)
+        return;
+    region->chunks[chunkIndex].reset();
+    region->occupied &= ~(uint64_t{1} << chunkIndex);
+    --m_size;
+
+    // Shrinking the bounds needs a pass over the siblings, so it is deferred to the next cull.
+    superRegion.boundsDirty = true;
+    if (region->occupied != 0)
+    {
+        region->boundsDirty = true;
+        return;
+    }
+    region.reset();
+    superRegion.occupied &= ~(uint64_t{1} << regionIndex);
+    if (superRegion.occupied == 0)
+        m_superRegions.erase(it);
+}
+
+void ChunkRegionTree::refreshBounds(Region &region)
+{
+    if (!region.boundsDirty)
+        return;
+    bool empty = true;
+    for (uint64_t bits = region.occupied; bits != 0; bits &= bits - 1)
+    {
+        growBounds(region.bounds, empty, region.chunks[std::countr_zero(bits)]->getExpandedAABB());
+        empty = false;
+    }
+    region.boundsDirty = false;
+}
+
+void ChunkRegionTree::refreshBounds(SuperRegion &superRegion)
+{
+    if (!superRegion.boundsDirty)
+        return;
+    bool empty = true;
+    for (uint64_t bits = superRegion.occupied; bits != 0; bits &= bits - 1)
+    {
+        Region &region = *superRegion.regions[std::countr_zero(bits)];
+        refreshBounds(region);
+        growBounds(superRegion.bounds, empty, region.bounds);
+        empty = false;
+    }
+    superRegion.boundsDirty = false;
+}
+
+void ChunkRegionTree::appendAll(const Region &region, std::vector<std::shared_ptr<Chunk>> &out)
+{
+    for (uint64_t bits = region.occupied; bits != 0; bits &= bits - 1)
+        out.push_back(region.chunks[std::countr_zero(bits)]);
+}
+
+void ChunkRegionTree::collectVisible(const Camera &camera, std::vector<std::shared_ptr<Chunk>> &out)
+{
+    for (auto &[key, superRegionPtr] : m_superRegions)
+    {
+        SuperRegion &superRegion = *superRegionPtr;
+        refreshBounds(superRegion);
+        const FrustumTest superTest = camera.classifyAABB(superRegion.bounds.min, superRegion.bounds.max);
+        if (superTest == FrustumTest::OUTSIDE)
+            continue;
+
+        for (uint64_t regionBits = superRegion.occupied; regionBits != 0; regionBits &= regionBits - 1)
+        {
+            const Region &region = *superRegion.regions[std::countr_zero(regionBits)];
+            const FrustumTest regionTest = (superTest == FrustumTest::INSIDE)
+                                               ? FrustumTest::INSIDE
+                                               : camera.classifyAABB(region.bounds.min, region.bounds.max);
+            if (regionTest == FrustumTest::OUTSIDE)
+                continue;
+            if (regionTest == FrustumTest::INSIDE)
+            {
+                appendAll(region, out);
+                continue;
+            }
+
+            uint64_t visible;
+            camera.areAABBsVisible(region.chunkBoundsArrays(), REGION_VOL, &visible);
+            for (uint64_t chunkBits = region.occupied & visible; chunkBits != 0; chunkBits &= chunkBits - 1)
+                out.push_back(region.chunks[std::countr_zero(chunkBits)]);
+        }
+    }
+}
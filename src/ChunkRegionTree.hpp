@@ -0,0 +1,99 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Chunk.hpp"
+#include "Camera.hpp"
+
+/**
+ * @class ChunkRegionTree
+ * @brief A two-level spatial hierarchy over the chunks drawn with CPU culling, for hierarchical frustum culling.
+ *
+ * Chunks are grouped into regions of REGION_DIM^3 chunks, and regions into super-regions of REGION_DIM^3
+ * regions (so REGION_DIM^6 chunks); super-regions are kept in a hash table by coordinate. Every node caches
+ * the union of its children's bounds. Culling classifies a node against the frustum once: an outside node
+ * is rejected with all its chunks, an inside node yields all its chunks without further tests, and only
+ * nodes crossing a frustum plane are descended into. The chunks of a crossing region are tested together
+ * with Camera::areAABBsVisible, from bounds each region keeps in structure-of-arrays layout.
+ *
+ * The tree is updated incrementally: inserting a chunk grows the cached bounds of its nodes, removing one
+ * marks them for recomputation at the next cull, and emptied nodes are deleted. Not thread-safe.
+ */
+class ChunkRegionTree
+{
+public:
+    // Chunks (or regions) per axis of a region (or super-region).
+    static constexpr int REGION_SHIFT = 2;
+    static constexpr int REGION_DIM = 1 << REGION_SHIFT;
+    static constexpr int REGION_VOL = REGION_DIM * REGION_DIM * REGION_DIM;
+    static_assert(REGION_VOL == 64, "Node occupancy is tracked in a 64-bit mask.");
+
+    /**
+     * @brief Adds a chunk, or replaces the chunk already at its coordinate.
+     */
+    void insert(const std::shared_ptr<Chunk> &chunk);
+
+    /**
+     * @brief Removes a chunk. Does nothing if its coordinate holds a different chunk (or none).
+     */
+    void remove(const std::shared_ptr<Chunk> &chunk);
+
+    /**
+     * @brief Appends every chunk whose expanded AABB intersects the camera's frustum.
+     * @param camera The camera, with an up-to-date frustum.
+     * @param out Receives the visible chunks, grouped by region.
+     */
+    void collectVisible(const Camera &camera, std::vector<std::shared_ptr<Chunk>> &out);
+
+    size_t size() const { return m_size; }
+
+private:
+    struct Region
+    {
+        std::array<std::shared_ptr<Chunk>, REGION_VOL> chunks{};
+        uint64_t occupied = 0; // Bit i: chunks[i] is set
+        AABB bounds{};
+        bool boundsDirty = false;
+        // The expanded AABBs of the chunks: min x, y, z, then max x, y, z. Stale for unoccupied entries.
+        alignas(32) float chunkBounds[6][REGION_VOL]{};
+
+        AABBArrays chunkBoundsArrays() const
+        {
+            return {chunkBounds[0], chunkBounds[1], chunkBounds[2], chunkBounds[3], chunkBounds[4], chunkBounds[5]};
+        }
+    };
+
+    struct SuperRegion
+    {
+        std::array<std::unique_ptr<Region>, REGION_VOL> regions{};
+        uint64_t occupied = 0; // Bit i: regions[i] is set
+        AABB bounds{};
+        bool boundsDirty = false;
+    };
+
+    std::unordered_map<uint64_t, std::unique_ptr<SuperRegion>> m_superRegions;
+    size_t m_size = 0;
+
+    // The index of a chunk (or region) within its parent node, from its coordinate.
+    static int childIndex(const glm::ivec3 &coord)
+    {
+        constexpr int mask = REGION_DIM - 1;
+        return ((coord.x & mask) * REGION_DIM + (coord.y & mask)) * REGION_DIM + (coord.z & mask);
+    }
+
+    // The coordinate of the node containing a chunk (or region). Arithmetic shifts floor negative coordinates.
+    static glm::ivec3 parentCoord(const glm::ivec3 &coord)
+    {
+        return glm::ivec3(coord.x >> REGION_SHIFT, coord.y >> REGION_SHIFT, coord.z >> REGION_SHIFT);
+    }
+
+    static void growBounds(AABB &bounds, bool wasEmpty, const AABB &childBounds);
+    static void refreshBounds(Region &region);
+    static void refreshBounds(SuperRegion &superRegion);
+    static void appendAll(const Region &region, std::vector<std::shared_ptr<Chunk>> &out);
+};
@@ -2,14 +2,19 @@
 #include <iostream>
 #include <algorithm>
 #include <optional>
+#include <stdexcept>
+#include <cstddef>
 
-// Includes the Vertex struct definition, required for buffer layouts and data uploads.
-#include "Vertex.hpp"
+// Includes the Quad struct definition, required for buffer sizes and data uploads.
+#include "Quad.hpp"
 
 // Constructor
-ChunkRenderer::ChunkRenderer(uint32_t poolVertexCapacity, uint32_t poolIndexCapacity)
-    : m_poolVertexCapacity(poolVertexCapacity), m_poolIndexCapacity(poolIndexCapacity)
+ChunkRenderer::ChunkRenderer(uint32_t poolQuadCapacity)
+    : m_poolQuadCapacity(poolQuadCapacity)
 {
+    createQuadIndexBuffer();
+    glCreateBuffers(1, &m_originBuffer);
+    glCreateBuffers(1, &m_commandBuffer);
     // Start with one pool.
     createNewPool();
 }
@@ -18,108 +23,91 @@ ChunkRenderer::ChunkRenderer(uint32_t poolVertexCapacity, uint32_t poolIndexCapa
 ChunkRenderer::~ChunkRenderer()
 {
     for (auto& pool : m_pools) {
-        glDeleteVertexArrays(1, &pool.vao);
-        glDeleteBuffers(1, &pool.vbo);
-        glDeleteBuffers(1, &pool.ebo);
+        glDeleteBuffers(1, &pool.ssbo);
+    }
+    glDeleteVertexArrays(1, &m_vao);
+    glDeleteBuffers(1, &m_quadIndexBuffer);
+    glDeleteBuffers(1, &m_originBuffer);
+    glDeleteBuffers(1, &m_commandBuffer);
+    if (m_cullProgram != 0) {
+        glDeleteProgram(m_cullProgram);
+        glDeleteBuffers(1, &m_cullRecordBuffer);
+        glDeleteBuffers(1, &m_cullOriginBuffer);
+        glDeleteBuffers(1, &m_poolCommandBaseBuffer);
+        glDeleteBuffers(1, &m_drawCountBuffer);
+        glDeleteBuffers(1, &m_culledCommandBuffer);
+        glDeleteBuffers(1, &m_visibleSlotBuffer);
     }
 }
 
-// Creates and initializes a new, empty BufferPool.
-void ChunkRenderer::createNewPool()
+// Builds the index pattern shared by every mesh: two triangles per quad, over corners 0-3 of each.
+// Corner c of a quad is at origin + (c == 1 || c == 2) * u + (c >= 2) * v, so (0, 1, 2), (0, 2, 3)
+// winds counter-clockwise for positive faces; the shader swaps corners 1 and 3 on negative faces.
+void ChunkRenderer::createQuadIndexBuffer()
 {
-    m_pools.emplace_back(BufferPool{
-        .vertexCapacity = m_poolVertexCapacity,
-        .indexCapacity = m_poolIndexCapacity
-    });
-    initializePool(m_pools.back());
-    
-    m_lastBoundVao = 0;
+    std::vector<unsigned short> indices;
+    indices.reserve(QUADS_PER_DRAW * 6);
+    for (uint32_t quad = 0; quad < QUADS_PER_DRAW; ++quad)
+    {
+        const unsigned short base = static_cast<unsigned short>(quad * 4);
+        indices.insert(indices.end(), {base, (unsigned short)(base + 1), (unsigned short)(base + 2), base, (unsigned short)(base + 2), (unsigned short)(base + 3)});
+    }
 
-    std::cout << "ChunkRenderer: No space found, creating new buffer pool (ID: " << m_pools.size() - 1 << ")." << std::endl;
+    glCreateVertexArrays(1, &m_vao);
+    glCreateBuffers(1, &m_quadIndexBuffer);
+    glNamedBufferStorage(m_quadIndexBuffer, indices.size() * sizeof(unsigned short), indices.data(), 0);
+    glVertexArrayElementBuffer(m_vao, m_quadIndexBuffer);
 }
 
-
-// Sets up the OpenGL buffers for a given pool.
-void ChunkRenderer::initializePool(BufferPool& pool)
+// Creates and initializes a new, empty BufferPool.
+void ChunkRenderer::createNewPool()
 {
-    glCreateVertexArrays(1, &pool.vao);
-    glBindVertexArray(pool.vao);
-
-    glGenBuffers(1, &pool.vbo);
-    glBindBuffer(GL_ARRAY_BUFFER, pool.vbo);
-    glBufferData(GL_ARRAY_BUFFER, pool.vertexCapacity * sizeof(Vertex), nullptr, GL_DYNAMIC_DRAW);
-
-    glGenBuffers(1, &pool.ebo);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, pool.ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, pool.indexCapacity * sizeof(unsigned short), nullptr, GL_DYNAMIC_DRAW);
-
-    // Position attribute (vec3) - Location 0
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
-    glEnableVertexAttribArray(0);
-
-    // Color attribute (4x uint8_t, normalized) - Location 1
-    glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex), (void*)offsetof(Vertex, color));
-    glEnableVertexAttribArray(1);
-    
-    // Normal attribute (3x int8_t, normalized) - Location 2
-    glVertexAttribPointer(2, 3, GL_BYTE, GL_TRUE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
-    glEnableVertexAttribArray(2);
-
-    // Atlas Offset attribute (vec2) - Location 3
-    glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, atlasOffset));
-    glEnableVertexAttribArray(3);
-
-    // Surface Coordinates attribute (vec2) - Location 4
-    glVertexAttribPointer(4, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, surfaceCoords));
-    glEnableVertexAttribArray(4);
-
-    glBindVertexArray(0);
+    BufferPool& pool = m_pools.emplace_back(BufferPool{
+        .quadCapacity = m_poolQuadCapacity
+    });
+    glCreateBuffers(1, &pool.ssbo);
+    glNamedBufferData(pool.ssbo, pool.quadCapacity * sizeof(Quad), nullptr, GL_DYNAMIC_DRAW);
 
     // Initialize the free list with a single block covering the entire buffer.
-    pool.freeList.push_back({0, 0, pool.vertexCapacity, pool.indexCapacity});
+    pool.freeList.push_back({0, pool.quadCapacity});
+
+    std::cout << "ChunkRenderer: No space found, creating new buffer pool (ID: " << m_pools.size() - 1 << ")." << std::endl;
 }
 
 // Tries to allocate a mesh within a specific pool.
-std::optional<MeshAllocation> ChunkRenderer::tryAllocateInPool(uint32_t poolIndex, const std::vector<Vertex>& vertices, const std::vector<unsigned short>& indices)
+std::optional<MeshAllocation> ChunkRenderer::tryAllocateInPool(uint32_t poolIndex, const std::vector<Quad>& quads)
 {
     BufferPool& pool = m_pools[poolIndex];
-    const uint32_t vertexCount = static_cast<uint32_t>(vertices.size());
-    const uint32_t indexCount = static_cast<uint32_t>(indices.size());
+    const uint32_t quadCount = static_cast<uint32_t>(quads.size());
 
     // Find the first free block that is large enough
     for (auto it = pool.freeList.begin(); it != pool.freeList.end(); ++it)
     {
-        if (it->vertexCapacity >= vertexCount && it->indexCapacity >= indexCount)
+        if (it->capacity >= quadCount)
         {
             BufferBlock block = *it;
             pool.freeList.erase(it);
 
             MeshAllocation allocation = {
                 poolIndex,
-                block.vertexOffset,
-                block.indexOffset,
-                vertexCount,
-                indexCount};
+                block.offset,
+                quadCount};
 
-            uint32_t remainingVertices = block.vertexCapacity - vertexCount;
-            uint32_t remainingIndices = block.indexCapacity - indexCount;
+            uint32_t remainingQuads = block.capacity - quadCount;
 
-            if (remainingVertices > 0 || remainingIndices > 0)
+            if (remainingQuads > 0)
             {
                 BufferBlock newFreeBlock = {
-                    block.vertexOffset + vertexCount,
-                    block.indexOffset + indexCount,
-                    remainingVertices,
-                    remainingIndices};
-                auto insert_pos = std::lower_bound(pool.freeList.begin(), pool.freeList.end(), newFreeBlock.vertexOffset,
+                    block.offset + quadCount,
+                    remainingQuads};
+                auto insert_pos = std::lower_bound(pool.freeList.begin(), pool.freeList.end(), newFreeBlock.offset,
                                                    [](const BufferBlock &b, uint32_t offset)
-                                                   { return b.vertexOffset < offset; });
+                                                   { return b.offset < offset; });
                 pool.freeList.insert(insert_pos, newFreeBlock);
             }
 
             // Use Direct State Access (DSA) to upload data without binding
-            glNamedBufferSubData(pool.vbo, allocation.vertexOffset * sizeof(Vertex), vertexCount * sizeof(Vertex), vertices.data());
-            glNamedBufferSubData(pool.ebo, allocation.indexOffset * sizeof(unsigned short), indexCount * sizeof(unsigned short), indices.data());
+            glNamedBufferSubData(pool.ssbo, allocation.quadOffset * sizeof(Quad), quadCount * sizeof(Quad), quads.data());
 
             return allocation;
         }
@@ -128,11 +116,14 @@ std::optional<MeshAllocation> ChunkRenderer::tryAllocateInPool(uint32_t poolInde
     return std::nullopt;
 }
 
-MeshAllocation ChunkRenderer::allocateMesh(const std::vector<Vertex> &vertices, const std::vector<unsigned short> &indices)
+MeshAllocation ChunkRenderer::allocateMesh(const std::vector<Quad> &quads)
 {
+    if (quads.empty())
+        return {};
+
     // Try to allocate in existing pools first.
     for (size_t i = 0; i < m_pools.size(); ++i) {
-        if (auto allocation = tryAllocateInPool(i, vertices, indices)) {
+        if (auto allocation = tryAllocateInPool(i, quads)) {
             return *allocation;
         }
     }
@@ -140,7 +131,7 @@ MeshAllocation ChunkRenderer::allocateMesh(const std::vector<Vertex> &vertices,
     // If no space was found, create a new pool.
     createNewPool();
 
-    if (auto allocation = tryAllocateInPool(m_pools.size() - 1, vertices, indices)) {
+    if (auto allocation = tryAllocateInPool(m_pools.size() - 1, quads)) {
         return *allocation;
     }
 
@@ -154,17 +145,18 @@ void ChunkRenderer::freeMesh(const MeshAllocation &allocation)
     if (!allocation.isValid() || allocation.poolIndex >= m_pools.size())
         return;
 
+    if (allocation.cullSlot != MeshAllocation::NO_CULL_SLOT)
+        removeCulledMesh(allocation.cullSlot);
+
     BufferPool& pool = m_pools[allocation.poolIndex];
 
     BufferBlock freedBlock = {
-        allocation.vertexOffset,
-        allocation.indexOffset,
-        allocation.vertexCount,
-        allocation.indexCount};
+        allocation.quadOffset,
+        allocation.quadCount};
 
-    auto it = std::lower_bound(pool.freeList.begin(), pool.freeList.end(), freedBlock.vertexOffset,
+    auto it = std::lower_bound(pool.freeList.begin(), pool.freeList.end(), freedBlock.offset,
                                [](const BufferBlock &b, uint32_t offset)
-                               { return b.vertexOffset < offset; });
+                               { return b.offset < offset; });
 
     auto inserted_it = pool.freeList.insert(it, freedBlock);
     mergeFreeBlocks(pool, inserted_it);
@@ -175,11 +167,9 @@ void ChunkRenderer::mergeFreeBlocks(BufferPool& pool, std::list<BufferBlock>::it
     if (it != pool.freeList.begin())
     {
         auto prev = std::prev(it);
-        if (prev->vertexOffset + prev->vertexCapacity == it->vertexOffset &&
-            prev->indexOffset + prev->indexCapacity == it->indexOffset)
+        if (prev->offset + prev->capacity == it->offset)
         {
-            prev->vertexCapacity += it->vertexCapacity;
-            prev->indexCapacity += it->indexCapacity;
+            prev->capacity += it->capacity;
             it = pool.freeList.erase(it);
             it = prev;
         }
@@ -187,30 +177,230 @@ void ChunkRenderer::mergeFreeBlocks(BufferPool& pool, std::list<BufferBlock>::it
     auto next = std::next(it);
     if (next != pool.freeList.end())
     {
-        if (it->vertexOffset + it->vertexCapacity == next->vertexOffset &&
-            it->indexOffset + it->indexCapacity == next->indexOffset)
+        if (it->offset + it->capacity == next->offset)
         {
-            it->vertexCapacity += next->vertexCapacity;
-            it->indexCapacity += next->indexCapacity;
+            it->capacity += next->capacity;
             pool.freeList.erase(next);
         }
     }
 }
 
-void ChunkRenderer::draw(const MeshAllocation &allocation) const
+void ChunkRenderer::queueDraw(const MeshAllocation &allocation, const glm::vec3 &chunkOrigin)
 {
-    if (allocation.poolIndex >= m_pools.size()) return;
-    const BufferPool& pool = m_pools[allocation.poolIndex];
-
-    if (m_lastBoundVao != pool.vao) {
-        glBindVertexArray(pool.vao);
-        m_lastBoundVao = pool.vao;
-    }
-    
-    glDrawElementsBaseVertex(
-        GL_TRIANGLES,
-        allocation.indexCount,
-        GL_UNSIGNED_SHORT, // Use 16-bit indices
-        (void *)(sizeof(unsigned short) * allocation.indexOffset),
-        allocation.vertexOffset);
+    if (!allocation.isValid() || allocation.poolIndex >= m_pools.size()) return;
+
+    const uint32_t drawIndex = static_cast<uint32_t>(m_queuedOrigins.size());
+    m_queuedOrigins.emplace_back(chunkOrigin, 0.0f);
+
+    // A mesh larger than the index pattern (only possible for pathological block layouts) takes several commands.
+    auto &commands = m_pools[allocation.poolIndex].queuedCommands;
+    for (uint32_t first = 0; first < allocation.quadCount; first += QUADS_PER_DRAW)
+    {
+        const uint32_t quadCount = std::min(allocation.quadCount - first, QUADS_PER_DRAW);
+        commands.push_back({
+            .count = quadCount * 6,
+            .instanceCount = 1,
+            .firstIndex = 0,
+            .baseVertex = static_cast<int32_t>((allocation.quadOffset + first) * 4),
+            .baseInstance = drawIndex});
+    }
+}
+
+void ChunkRenderer::submitDraws()
+{
+    if (m_queuedOrigins.empty())
+        return;
+
+    // Lay the pools' commands out back to back, remembering where each pool's run starts.
+    m_commandUpload.clear();
+    std::vector<std::pair<uint32_t, size_t>> poolRuns; // (pool, first command)
+    for (uint32_t i = 0; i < m_pools.size(); ++i)
+    {
+        auto &commands = m_pools[i].queuedCommands;
+        if (commands.empty())
+            continue;
+        poolRuns.emplace_back(i, m_commandUpload.size());
+        m_commandUpload.insert(m_commandUpload.end(), commands.begin(), commands.end());
+        commands.clear();
+    }
+
+    // Re-specifying the whole store lets the driver orphan the buffers still in use by the previous pass.
+    glNamedBufferData(m_originBuffer, m_queuedOrigins.size() * sizeof(glm::vec4), m_queuedOrigins.data(), GL_STREAM_DRAW);
+    glNamedBufferData(m_commandBuffer, m_commandUpload.size() * sizeof(DrawElementsIndirectCommand), m_commandUpload.data(), GL_STREAM_DRAW);
+    m_queuedOrigins.clear();
+
+    // Other passes (e.g. terrain generation) share the storage buffer bindings, so bind everything afresh.
+    glBindVertexArray(m_vao);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, ORIGIN_BUFFER_BINDING, m_originBuffer);
+    for (size_t run = 0; run < poolRuns.size(); ++run)
+    {
+        const auto [poolIndex, firstCommand] = poolRuns[run];
+        const size_t endCommand = (run + 1 < poolRuns.size()) ? poolRuns[run + 1].second : m_commandUpload.size();
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, QUAD_BUFFER_BINDING, m_pools[poolIndex].ssbo);
+        glMultiDrawElementsIndirect(
+            GL_TRIANGLES,
+            GL_UNSIGNED_SHORT, // Use 16-bit indices
+            reinterpret_cast<const void *>(firstCommand * sizeof(DrawElementsIndirectCommand)),
+            static_cast<GLsizei>(endCommand - firstCommand),
+            0); // Tightly packed
+    }
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+// Compiles the culling compute shader and creates its buffers.
+void ChunkRenderer::enableGpuCulling(std::string_view cullComputeSrc)
+{
+    GLuint computeShader = glCreateShader(GL_COMPUTE_SHADER);
+    const char *srcData = cullComputeSrc.data();
+    GLint srcLength = static_cast<GLint>(cullComputeSrc.size());
+    glShaderSource(computeShader, 1, &srcData, &srcLength);
+    glCompileShader(computeShader);
+    GLint success;
+    glGetShaderiv(computeShader, GL_COMPILE_STATUS, &success);
+    if (!success) {
+        GLchar infoLog[512];
+        glGetShaderInfoLog(computeShader, 512, NULL, infoLog);
+        std::cerr << "Error: ChunkRenderer: Culling shader compilation failed:\n" << infoLog << std::endl;
+        glDeleteShader(computeShader);
+        throw std::runtime_error("Culling shader compilation failed.");
+    }
+
+    GLuint program = glCreateProgram();
+    glAttachShader(program, computeShader);
+    glLinkProgram(program);
+    glDeleteShader(computeShader);
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        GLchar infoLog[512];
+        glGetProgramInfoLog(program, 512, NULL, infoLog);
+        std::cerr << "Error: ChunkRenderer: Culling program linking failed:\n" << infoLog << std::endl;
+        glDeleteProgram(program);
+        throw std::runtime_error("Culling program linking failed.");
+    }
+    m_cullProgram = program;
+    m_cullRecordCountLocation = glGetUniformLocation(program, "u_recordCount");
+    m_cullPlanesLocation = glGetUniformLocation(program, "u_frustumPlanes");
+    m_cullUseVisibleSlotsLocation = glGetUniformLocation(program, "u_useVisibleSlots");
+
+    glCreateBuffers(1, &m_cullRecordBuffer);
+    glCreateBuffers(1, &m_cullOriginBuffer);
+    glCreateBuffers(1, &m_poolCommandBaseBuffer);
+    glCreateBuffers(1, &m_drawCountBuffer);
+    glCreateBuffers(1, &m_culledCommandBuffer);
+    glCreateBuffers(1, &m_visibleSlotBuffer);
+    // Never empty, so it can stay bound when no mask is given.
+    glNamedBufferData(m_visibleSlotBuffer, sizeof(uint32_t), nullptr, GL_STREAM_DRAW);
+}
+
+void ChunkRenderer::addCulledMesh(MeshAllocation &allocation, const glm::vec3 &boundsMin, const glm::vec3 &boundsMax, const glm::vec3 &chunkOrigin)
+{
+    if (m_cullProgram == 0 || !allocation.isValid() || allocation.cullSlot != MeshAllocation::NO_CULL_SLOT)
+        return;
+
+    uint32_t slot;
+    if (!m_freeCullSlots.empty()) {
+        slot = m_freeCullSlots.back();
+        m_freeCullSlots.pop_back();
+    } else {
+        slot = static_cast<uint32_t>(m_cullRecords.size());
+        m_cullRecords.emplace_back();
+        m_cullOrigins.emplace_back();
+    }
+
+    m_cullRecords[slot] = {glm::vec4(boundsMin, 0.0f), glm::vec4(boundsMax, 0.0f), allocation.poolIndex, allocation.quadOffset, allocation.quadCount, 0};
+    m_cullOrigins[slot] = glm::vec4(chunkOrigin, 0.0f);
+    m_pools[allocation.poolIndex].culledCommandCount += commandCountOf(allocation.quadCount);
+    allocation.cullSlot = slot;
+
+    if (m_cullRecords.size() > m_cullBufferCapacity) {
+        // Grow geometrically and upload the whole mirror; drawCulled() only reads the first m_cullRecords.size() records.
+        m_cullBufferCapacity = std::max<uint32_t>(1024, m_cullBufferCapacity * 2);
+        glNamedBufferData(m_cullRecordBuffer, m_cullBufferCapacity * sizeof(CullRecord), nullptr, GL_DYNAMIC_DRAW);
+        glNamedBufferSubData(m_cullRecordBuffer, 0, m_cullRecords.size() * sizeof(CullRecord), m_cullRecords.data());
+        glNamedBufferData(m_cullOriginBuffer, m_cullBufferCapacity * sizeof(glm::vec4), nullptr, GL_DYNAMIC_DRAW);
+        glNamedBufferSubData(m_cullOriginBuffer, 0, m_cullOrigins.size() * sizeof(glm::vec4), m_cullOrigins.data());
+    } else {
+        glNamedBufferSubData(m_cullRecordBuffer, slot * sizeof(CullRecord), sizeof(CullRecord), &m_cullRecords[slot]);
+        glNamedBufferSubData(m_cullOriginBuffer, slot * sizeof(glm::vec4), sizeof(glm::vec4), &m_cullOrigins[slot]);
+    }
+}
+
+// Marks a cull record free (a zero quad count, which the culling shader skips) and recycles its slot.
+void ChunkRenderer::removeCulledMesh(uint32_t cullSlot)
+{
+    if (cullSlot >= m_cullRecords.size())
+        return;
+
+    CullRecord &record = m_cullRecords[cullSlot];
+    m_pools[record.poolIndex].culledCommandCount -= commandCountOf(record.quadCount);
+    record.quadCount = 0;
+    glNamedBufferSubData(m_cullRecordBuffer, cullSlot * sizeof(CullRecord) + offsetof(CullRecord, quadCount), sizeof(uint32_t), &record.quadCount);
+    m_freeCullSlots.push_back(cullSlot);
+}
+
+void ChunkRenderer::drawCulled(const std::array<glm::vec4, 6> &frustumPlanes, const std::vector<uint32_t> *visibleSlots)
+{
+    if (m_cullProgram == 0 || m_cullRecords.empty())
+        return;
+
+    // Give every pool a command region large enough for all of its registered meshes.
+    std::vector<uint32_t> poolCommandBase(m_pools.size());
+    uint32_t commandTotal = 0;
+    for (size_t i = 0; i < m_pools.size(); ++i) {
+        poolCommandBase[i] = commandTotal;
+        commandTotal += m_pools[i].culledCommandCount;
+    }
+    if (commandTotal == 0)
+        return;
+    if (commandTotal > m_culledCommandCapacity) {
+        m_culledCommandCapacity = std::max(commandTotal, m_culledCommandCapacity * 2);
+        glNamedBufferData(m_culledCommandBuffer, m_culledCommandCapacity * sizeof(DrawElementsIndirectCommand), nullptr, GL_DYNAMIC_DRAW);
+    }
+    glNamedBufferData(m_poolCommandBaseBuffer, poolCommandBase.size() * sizeof(uint32_t), poolCommandBase.data(), GL_STREAM_DRAW);
+    glNamedBufferData(m_drawCountBuffer, m_pools.size() * sizeof(uint32_t), nullptr, GL_STREAM_DRAW);
+    glClearNamedBufferData(m_drawCountBuffer, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+
+    // --- Cull ---
+    GLint renderProgram = 0;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &renderProgram);
+    const uint32_t recordCount = static_cast<uint32_t>(m_cullRecords.size());
+    glProgramUniform1ui(m_cullProgram, m_cullRecordCountLocation, recordCount);
+    glProgramUniform4fv(m_cullProgram, m_cullPlanesLocation, 6, &frustumPlanes[0][0]);
+    const bool useVisibleSlots = visibleSlots && visibleSlots->size() >= visibleSlotWordCount();
+    glProgramUniform1i(m_cullProgram, m_cullUseVisibleSlotsLocation, useVisibleSlots);
+    if (useVisibleSlots)
+        glNamedBufferData(m_visibleSlotBuffer, visibleSlots->size() * sizeof(uint32_t), visibleSlots->data(), GL_STREAM_DRAW);
+    glUseProgram(m_cullProgram);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_cullRecordBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, m_poolCommandBaseBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, m_drawCountBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, m_culledCommandBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, m_visibleSlotBuffer);
+    glDispatchCompute((recordCount + CULL_WORKGROUP_SIZE - 1) / CULL_WORKGROUP_SIZE, 1, 1);
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT);
+
+    // Restore the caller's (render) program.
+    glUseProgram(static_cast<GLuint>(renderProgram));
+
+    // --- Draw ---
+    glBindVertexArray(m_vao);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_culledCommandBuffer);
+    glBindBuffer(GL_PARAMETER_BUFFER, m_drawCountBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, ORIGIN_BUFFER_BINDING, m_cullOriginBuffer);
+    for (uint32_t i = 0; i < m_pools.size(); ++i)
+    {
+        if (m_pools[i].culledCommandCount == 0)
+            continue;
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, QUAD_BUFFER_BINDING, m_pools[i].ssbo);
+        glMultiDrawElementsIndirectCount(
+            GL_TRIANGLES,
+            GL_UNSIGNED_SHORT, // Use 16-bit indices
+            reinterpret_cast<const void *>(static_cast<uintptr_t>(poolCommandBase[i]) * sizeof(DrawElementsIndirectCommand)),
+            static_cast<GLintptr>(i * sizeof(uint32_t)),
+            static_cast<GLsizei>(m_pools[i].culledCommandCount),
+            0); // Tightly packed
+    }
+    glBindBuffer(GL_PARAMETER_BUFFER, 0);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
 }
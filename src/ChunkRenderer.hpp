@@ -4,51 +4,127 @@
 #include <vector>
 #include <list>
 #include <optional>
+#include <cstdint>
+#include <array>
+#include <string_view>
+#include <glm/glm.hpp>
 
 #include "MeshAllocation.hpp"
 
 // Forward-declaration
-struct Vertex;
+struct Quad;
 
+/**
+ * @class ChunkRenderer
+ * @brief Stores chunk meshes in large shared GPU buffers and draws them.
+ *
+ * Meshes are stored as one packed Quad per greedy quad in shader storage buffers (pools), which
+ * core.vert.glsl reads directly ("vertex pulling"). Every quad is drawn as the same two triangles,
+ * so one static index buffer holding that pattern for QUADS_PER_DRAW quads is shared by all pools:
+ * drawing a mesh sets the base vertex to four times its quad offset, and the shader recovers the
+ * quad (gl_VertexID / 4) and its corner (gl_VertexID % 4).
+ *
+ * Draws are batched: queueDraw() records an indirect draw command per mesh and its chunk origin, and
+ * submitDraws() uploads them and renders each pool with a single glMultiDrawElementsIndirect. The
+ * shader reads the chunk origin from a storage buffer indexed by gl_BaseInstance.
+ *
+ * With GPU culling enabled, meshes registered with addCulledMesh() are kept in a persistent buffer of
+ * cull records (bounds plus allocation). drawCulled() frustum-culls all of them in a compute shader
+ * that writes the commands and per-pool draw counts for glMultiDrawElementsIndirectCount, so its CPU
+ * cost does not depend on the number of meshes.
+ */
 class ChunkRenderer
 {
 private:
-    // Represents a contiguous block of free space in a VBO and EBO.
+    // The command layout read by glMultiDrawElementsIndirect.
+    struct DrawElementsIndirectCommand
+    {
+        uint32_t count;
+        uint32_t instanceCount;
+        uint32_t firstIndex;
+        int32_t baseVertex;
+        uint32_t baseInstance; // Indexes the chunk origin buffer
+    };
+
+    // Represents a contiguous range of free quads in a pool.
     struct BufferBlock
     {
-        uint32_t vertexOffset;
-        uint32_t indexOffset;
-        uint32_t vertexCapacity;
-        uint32_t indexCapacity;
+        uint32_t offset;
+        uint32_t capacity;
     };
 
-    // A set of GPU buffers (VAO, VBO, EBO) and its associated memory manager.
+    // A quad storage buffer and its associated memory manager.
     struct BufferPool
     {
-        GLuint vao = 0;
-        GLuint vbo = 0;
-        GLuint ebo = 0;
-        uint32_t vertexCapacity;
-        uint32_t indexCapacity;
+        GLuint ssbo = 0;
+        uint32_t quadCapacity;
         // A list of free blocks, kept sorted by offset to allow for merging.
         std::list<BufferBlock> freeList{};
+        // The draws queued for this pool since the last submitDraws().
+        std::vector<DrawElementsIndirectCommand> queuedCommands{};
+        // The most commands drawCulled() can write for this pool: those of all its registered meshes.
+        uint32_t culledCommandCount = 0;
+    };
+
+    // A mesh registered for GPU culling, laid out as CullRecord in chunk_cull.comp.glsl.
+    struct CullRecord
+    {
+        glm::vec4 boundsMin; // xyz, w unused
+        glm::vec4 boundsMax; // xyz, w unused
+        uint32_t poolIndex;
+        uint32_t quadOffset;
+        uint32_t quadCount; // 0 for a free record
+        uint32_t padding;
     };
 
     std::vector<BufferPool> m_pools;
-    const uint32_t m_poolVertexCapacity;
-    const uint32_t m_poolIndexCapacity;
-    
-    // Tracks the last bound VAO to avoid redundant binds.
-    mutable GLuint m_lastBoundVao = 0;
+    const uint32_t m_poolQuadCapacity;
+
+    // The attribute-less VAO that holds the shared quad index buffer.
+    GLuint m_vao = 0;
+    GLuint m_quadIndexBuffer = 0;
+
+    // The per-draw chunk origins (xyz, w unused) and the indirect commands of all pools, rebuilt on every submit.
+    std::vector<glm::vec4> m_queuedOrigins;
+    std::vector<DrawElementsIndirectCommand> m_commandUpload;
+    GLuint m_originBuffer = 0;
+    GLuint m_commandBuffer = 0;
+
+    // GPU culling state. The records and their chunk origins (indexed alike) mirror the GPU buffers.
+    GLuint m_cullProgram = 0;
+    GLint m_cullRecordCountLocation = -1;
+    GLint m_cullPlanesLocation = -1;
+    GLint m_cullUseVisibleSlotsLocation = -1;
+    std::vector<CullRecord> m_cullRecords;
+    std::vector<glm::vec4> m_cullOrigins;
+    std::vector<uint32_t> m_freeCullSlots;
+    uint32_t m_cullBufferCapacity = 0;  // In records
+    uint32_t m_culledCommandCapacity = 0; // In commands
+    GLuint m_cullRecordBuffer = 0;
+    GLuint m_cullOriginBuffer = 0;
+    GLuint m_poolCommandBaseBuffer = 0;
+    GLuint m_drawCountBuffer = 0;
+    GLuint m_culledCommandBuffer = 0;
+    GLuint m_visibleSlotBuffer = 0;
 
     // Private helper methods
     void createNewPool();
-    void initializePool(BufferPool& pool);
-    std::optional<MeshAllocation> tryAllocateInPool(uint32_t poolIndex, const std::vector<Vertex>& vertices, const std::vector<unsigned short>& indices);
+    void createQuadIndexBuffer();
+    std::optional<MeshAllocation> tryAllocateInPool(uint32_t poolIndex, const std::vector<Quad>& quads);
     void mergeFreeBlocks(BufferPool& pool, std::list<BufferBlock>::iterator it);
+    void removeCulledMesh(uint32_t cullSlot);
+    static uint32_t commandCountOf(uint32_t quadCount) { return (quadCount + QUADS_PER_DRAW - 1) / QUADS_PER_DRAW; }
 
 public:
-    ChunkRenderer(uint32_t poolVertexCapacity, uint32_t poolIndexCapacity);
+    // The number of quads one draw call covers; the quad index pattern spans exactly 16-bit indices.
+    static constexpr uint32_t QUADS_PER_DRAW = 16384;
+    // The shader storage bindings of the quad and chunk origin buffers, see core.vert.glsl.
+    static constexpr GLuint QUAD_BUFFER_BINDING = 3;
+    static constexpr GLuint ORIGIN_BUFFER_BINDING = 4;
+    // The invocations per workgroup of chunk_cull.comp.glsl.
+    static constexpr uint32_t CULL_WORKGROUP_SIZE = 64;
+
+    explicit ChunkRenderer(uint32_t poolQuadCapacity);
     ~ChunkRenderer();
 
     // Prevent copying and moving to avoid issues with OpenGL resource ownership.
@@ -59,21 +135,57 @@ public:
 
     /**
      * @brief Allocates space in the GPU buffers for a mesh. May create a new buffer pool if needed.
-     * @param vertices The vertex data for the mesh.
-     * @param indices The index data for the mesh.
+     * @param quads The quads of the mesh.
      * @return A MeshAllocation struct representing the location and size of the allocated mesh.
      */
-    MeshAllocation allocateMesh(const std::vector<Vertex> &vertices, const std::vector<unsigned short> &indices);
+    MeshAllocation allocateMesh(const std::vector<Quad> &quads);
     
+    /**
+     * @brief Compiles the culling compute shader, enabling addCulledMesh() and drawCulled().
+     * @param cullComputeSrc The source of chunk_cull.comp.glsl.
+     * @throws std::runtime_error If the shader fails to compile or link.
+     */
+    void enableGpuCulling(std::string_view cullComputeSrc);
+    bool isGpuCullingEnabled() const { return m_cullProgram != 0; }
+
+    /**
+     * @brief Registers a mesh to be drawn by drawCulled() whenever its bounds are in the frustum.
+     *        freeMesh() unregisters it again.
+     * @param allocation The mesh, as returned by allocateMesh(). Receives its cull slot.
+     * @param boundsMin The minimum corner of the mesh's world-space bounds.
+     * @param boundsMax The maximum corner of the mesh's world-space bounds.
+     * @param chunkOrigin The world-space position of the mesh's chunk.
+     */
+    void addCulledMesh(MeshAllocation &allocation, const glm::vec3 &boundsMin, const glm::vec3 &boundsMax, const glm::vec3 &chunkOrigin);
+
+    // The number of words a cull slot bitmask for drawCulled() needs to cover every registered mesh.
+    size_t visibleSlotWordCount() const { return (m_cullRecords.size() + 31) / 32; }
+
     /**
      * @brief Frees a previously allocated mesh, making its space available for reuse.
      * @param allocation The MeshAllocation struct to free.
      */
     void freeMesh(const MeshAllocation &allocation);
-    
+
     /**
-     * @brief Issues a draw call for a specific mesh allocation, binding the correct VAO if necessary.
+     * @brief Queues a mesh to be drawn by the next submitDraws(). Draws in the same pool keep their queue order.
      * @param allocation The mesh to draw.
+     * @param chunkOrigin The world-space position of the mesh's chunk.
+     */
+    void queueDraw(const MeshAllocation &allocation, const glm::vec3 &chunkOrigin);
+
+    /**
+     * @brief Draws all queued meshes, one multi-draw per pool in pool order, and clears the queue.
+     */
+    void submitDraws();
+
+    /**
+     * @brief Frustum-culls all registered meshes on the GPU and draws the visible ones, one
+     *        indirect-count multi-draw per pool. Requires enableGpuCulling().
+     * @param frustumPlanes The frustum planes, as computed by Camera::updateFrustum.
+     * @param visibleSlots Optionally, a bitmask over cull slots (bit i % 32 of word i / 32, see
+     *        MeshAllocation::cullSlot) of at least visibleSlotWordCount() words. Meshes whose bit is
+     *        clear are skipped, e.g. because they are occluded. Null draws every mesh in the frustum.
      */
-    void draw(const MeshAllocation &allocation) const;
+    void drawCulled(const std::array<glm::vec4, 6> &frustumPlanes, const std::vector<uint32_t> *visibleSlots = nullptr);
 };
@@ -0,0 +1,97 @@
+#include "ChunkRequestQueue.hpp"
+
+#include "Constants.hpp"
+
+#include <algorithm>
+
+namespace
+{
+    // How much further a chunk directly behind the player counts than one straight ahead.
+    constexpr float BEHIND_DISTANCE_FACTOR = 2.0f;
+    // How much further a chunk outside the view frustum counts than an on-screen one.
+    constexpr float OFF_SCREEN_DISTANCE_FACTOR = 1.5f;
+}
+
+ChunkRequestQueue::ChunkRequestQueue(int dropDistance)
+    : m_dropDistance(dropDistance)
+{
+}
+
+// Distance in chunks, stretched for chunks away from the view direction (a chunk straight ahead
+// keeps its distance, one directly behind counts BEHIND_DISTANCE_FACTOR times as far) and again
+// for chunks whose bounds fall outside the camera frustum.
+float ChunkRequestQueue::score(const glm::ivec3 &coord) const
+{
+    const glm::vec3 offset = glm::vec3(coord - m_view.chunkCoord);
+    const float distance = glm::length(offset);
+    if (distance < 1e-3f)
+    {
+        return 0.0f;
+    }
+
+    const float facing = glm::dot(offset / distance, m_view.front);
+    float score = distance * (1.0f + (BEHIND_DISTANCE_FACTOR - 1.0f) * 0.5f * (1.0f - facing));
+
+    if (m_view.camera)
+    {
+        const glm::vec3 min = glm::vec3(coord) * Constants::CHUNK_WIDTH;
+        if (!m_view.camera->isAABBVisible(min, min + glm::vec3(Constants::CHUNK_WIDTH)))
+        {
+            score *= OFF_SCREEN_DISTANCE_FACTOR;
+        }
+    }
+    return score;
+}
+
+void ChunkRequestQueue::push(const std::vector<glm::ivec3> &coords)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_heap.reserve(m_heap.size() + coords.size());
+    for (const auto &coord : coords)
+    {
+        m_heap.push_back({coord, score(coord)});
+        std::push_heap(m_heap.begin(), m_heap.end(), servedLater);
+    }
+}
+
+bool ChunkRequestQueue::tryPop(std::vector<glm::ivec3> &out, size_t maxCount)
+{
+    out.clear();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    while (out.size() < maxCount && !m_heap.empty())
+    {
+        std::pop_heap(m_heap.begin(), m_heap.end(), servedLater);
+        out.push_back(m_heap.back().coord);
+        m_heap.pop_back();
+    }
+    return !out.empty();
+}
+
+std::vector<glm::ivec3> ChunkRequestQueue::setView(const PlayerView &view)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_view = view;
+
+    const long long dropDistSq = static_cast<long long>(m_dropDistance) * m_dropDistance;
+    std::vector<glm::ivec3> dropped;
+    std::erase_if(m_heap, [&](const Request &request)
+    {
+        const glm::ivec3 d = request.coord - view.chunkCoord;
+        const bool drop = static_cast<long long>(d.x) * d.x + static_cast<long long>(d.y) * d.y + static_cast<long long>(d.z) * d.z > dropDistSq;
+        if (drop)
+            dropped.push_back(request.coord);
+        return drop;
+    });
+    for (auto &request : m_heap)
+    {
+        request.score = score(request.coord);
+    }
+    std::make_heap(m_heap.begin(), m_heap.end(), servedLater);
+    return dropped;
+}
+
+size_t ChunkRequestQueue::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_heap.size();
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <mutex>
+#include <optional>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Camera.hpp"
+
+// Where the player is and where they are looking, as seen by the chunk scheduler.
+struct PlayerView
+{
+    glm::ivec3 chunkCoord{0};
+    glm::vec3 front{0.0f, 0.0f, -1.0f};
+    // A copy of the camera with an up-to-date frustum, used to favour chunks that are on screen.
+    std::optional<Camera> camera;
+};
+
+/**
+ * @class ChunkRequestQueue
+ * @brief A thread-safe priority queue of chunk generation requests.
+ *
+ * Requests are served in order of a score computed from the current PlayerView (lower is
+ * served first), blending distance, the angle to the view direction and frustum inclusion.
+ * Whenever the view changes, every pending request is re-scored and those that fell outside
+ * the drop distance are discarded, so the queue never serves stale far-away work ahead of
+ * what is in front of the player.
+ */
+class ChunkRequestQueue
+{
+public:
+    explicit ChunkRequestQueue(int dropDistance);
+
+    // Adds a batch of requests, scored against the current view.
+    void push(const std::vector<glm::ivec3> &coords);
+
+    // Replaces `out` with up to `maxCount` of the highest-priority requests, best first.
+    // Returns false if the queue is empty.
+    bool tryPop(std::vector<glm::ivec3> &out, size_t maxCount);
+
+    // Re-scores all pending requests for a new view and drops the ones beyond the drop distance.
+    // Returns the dropped coordinates so the caller can reset their state.
+    std::vector<glm::ivec3> setView(const PlayerView &view);
+
+    size_t size() const;
+
+private:
+    struct Request
+    {
+        glm::ivec3 coord;
+        float score;
+    };
+
+    // Orders the heap so the lowest score is at the front.
+    static bool servedLater(const Request &a, const Request &b) { return a.score > b.score; }
+
+    float score(const glm::ivec3 &coord) const;
+
+    mutable std::mutex m_mutex;
+    std::vector<Request> m_heap;
+    PlayerView m_view;
+    int m_dropDistance;
+};
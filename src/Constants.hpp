@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+
 /**
  * @namespace Constants
  * @brief Defines global, compile-time constants for the game.
@@ -29,6 +31,32 @@ namespace Constants
     // The player's view distance, in chunks.
     constexpr int RENDER_DISTANCE = 32;
 
+    // How many chunks beyond the render distance a chunk is kept before it is unloaded.
+    constexpr int CHUNK_UNLOAD_MARGIN = 2;
+
+    // Store loaded chunks in a fixed ring buffer around the player (ChunkGrid) instead of a hash table (ChunkMap).
+    constexpr bool USE_CHUNK_RING_BUFFER = false;
+
+    // Generate terrain with the compute shader, overflowing to the CPU generator when the GPU is saturated.
+    // When false (or when GPU generation fails to initialize) all terrain is generated on the CPU.
+    constexpr bool USE_GPU_TERRAIN_GENERATION = true;
+
+    // Frustum-cull the opaque chunk meshes in a compute shader that writes the indirect draws.
+    // When false (or when the culling shader fails to initialize) they are culled on the CPU.
+    constexpr bool USE_GPU_CULLING = true;
+
+    // Only draw the chunks that the camera can see into through a path of chunks, walked outward from the
+    // camera's chunk through faces connected by non-opaque blocks (see World::collectReachableChunks).
+    // When false, every chunk mesh in the frustum is drawn.
+    constexpr bool USE_OCCLUSION_CULLING = true;
+
+    // The seed of the terrain noise; the same seed always generates the same world.
+    constexpr uint32_t WORLD_SEED = 0x5eed1234u;
+
+    // How many chunk columns of surface heights the terrain generators keep cached: twice the
+    // columns within the unload radius, so the cache survives the player turning back.
+    constexpr int HEIGHTMAP_CACHE_COLUMNS = 2 * (2 * (RENDER_DISTANCE + CHUNK_UNLOAD_MARGIN) + 1) * (2 * (RENDER_DISTANCE + CHUNK_UNLOAD_MARGIN) + 1);
+
     // The dimension of source block textures in pixels.
     constexpr int TEXTURE_SIZE_PX = 16;
 }
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "TerrainGenerator.hpp"
+#include "Constants.hpp"
+#include "HeightmapCache.hpp"
+#include <optional>
+
+/**
+ * @class CpuTerrainGenerator
+ * @brief Generates terrain on the calling thread, producing the same blocks as the compute shader.
+ *
+ * Surface heights (the multi-octave 2D noise) and the layering of blocks are vectorized with AVX2 or
+ * SSE4.1 when the CPU supports them (detected once at construction), with a scalar fallback. All paths
+ * are bit-identical. The 3D density only matters in a band around the surface and uses the scalar
+ * reference functions there.
+ * Surface heights are computed once per chunk column and kept in a HeightmapCache, which the GPU
+ * generator shares. generateChunk is thread-safe, so chunks can be generated on any number of worker threads.
+ */
+class CpuTerrainGenerator : public TerrainGenerator
+{
+public:
+    enum class SimdPath
+    {
+        SCALAR,
+        SSE41,
+        AVX2
+    };
+
+    // Picks the widest SIMD path the CPU supports, unless a narrower one is forced.
+    explicit CpuTerrainGenerator(uint32_t seed = Constants::WORLD_SEED, std::optional<SimdPath> forcedPath = std::nullopt);
+
+    uint32_t generateChunk(const glm::ivec3 &chunkCoord, BlockType *out) override;
+
+    SimdPath getSimdPath() const { return m_simdPath; }
+    const char *getSimdPathName() const;
+
+    // The surface heights of one chunk column, indexed [x][z].
+    using ColumnHeights = ColumnHeightmap::Heights;
+
+    // The column heightmaps behind this generator, computed with its SIMD path.
+    HeightmapCache &getHeightmapCache() { return m_heightmaps; }
+
+private:
+    SimdPath m_simdPath;
+    HeightmapCache m_heightmaps;
+
+    void computeHeights(int baseX, int baseZ, ColumnHeights &heights) const;
+    void fillBlocks(int baseY, const ColumnHeights &heights, BlockType *out) const;
+};
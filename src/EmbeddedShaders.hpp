@@ -7,4 +7,5 @@ struct EmbeddedShaders {
     static const std::string_view core_vert;
     static const std::string_view core_frag;
     static const std::string_view terrain_gen_comp;
+    static const std::string_view chunk_cull_comp;
 };
@@ -0,0 +1,253 @@
+#include "GpuTerrainGenerator.hpp"
+#include "Constants.hpp"
+#include <iostream>
+#include <stdexcept>
+#include <cstring> // Required for memcpy
+#include <bit>
+#include <algorithm>
+
+// The packed block bytes written by the shader are read back as BlockType without any unpacking.
+static_assert(std::endian::native == std::endian::little, "GpuTerrainGenerator assumes a little-endian host.");
+
+// Constructor
+GpuTerrainGenerator::GpuTerrainGenerator(std::string_view computeSrc, HeightmapCache &heightmaps, uint32_t seed)
+    : TerrainGenerator(seed), m_heightmaps(heightmaps)
+{
+    GLuint computeShader = glCreateShader(GL_COMPUTE_SHADER);
+    const char *srcData = computeSrc.data();
+    GLint srcLength = static_cast<GLint>(computeSrc.size());
+    glShaderSource(computeShader, 1, &srcData, &srcLength);
+    glCompileShader(computeShader);
+    GLint success;
+    glGetShaderiv(computeShader, GL_COMPILE_STATUS, &success);
+    if (!success) {
+        GLchar infoLog[512];
+        glGetShaderInfoLog(computeShader, 512, NULL, infoLog);
+        std::cerr << "Error: GpuTerrainGenerator: Compute shader compilation failed:\n" << infoLog << std::endl;
+        glDeleteShader(computeShader);
+        throw std::runtime_error("Compute shader compilation failed.");
+    }
+
+    m_computeProgramID = glCreateProgram();
+    glAttachShader(m_computeProgramID, computeShader);
+    glLinkProgram(m_computeProgramID);
+    glGetProgramiv(m_computeProgramID, GL_LINK_STATUS, &success);
+    if (!success) {
+        GLchar infoLog[512];
+        glGetProgramInfoLog(m_computeProgramID, 512, NULL, infoLog);
+        std::cerr << "Error: GpuTerrainGenerator: Compute program linking failed:\n" << infoLog << std::endl;
+        glDeleteShader(computeShader);
+        glDeleteProgram(m_computeProgramID);
+        throw std::runtime_error("Compute program linking failed.");
+    }
+    glDeleteShader(computeShader);
+    glProgramUniform1ui(m_computeProgramID, glGetUniformLocation(m_computeProgramID, "u_seed"), m_seed);
+
+    constexpr size_t bufferSize = JOB_BUFFER_SIZE;
+
+    // Initialize the batch slots: output SSBO, coordinate and heightmap buffers, and timer query
+    m_slots.resize(MAX_CONCURRENT_JOBS);
+    for (int i = 0; i < MAX_CONCURRENT_JOBS; ++i)
+    {
+        BatchSlot &slot = m_slots[i];
+        glCreateBuffers(1, &slot.ssbo);
+        glNamedBufferData(slot.ssbo, bufferSize, nullptr, GL_DYNAMIC_DRAW);
+        glCreateBuffers(1, &slot.coordsBuffer);
+        glNamedBufferData(slot.coordsBuffer, MAX_BATCH_SIZE * sizeof(glm::ivec4), nullptr, GL_DYNAMIC_DRAW);
+        glCreateBuffers(1, &slot.heightsBuffer);
+        glNamedBufferData(slot.heightsBuffer, MAX_BATCH_SIZE * sizeof(ColumnHeightmap::Heights), nullptr, GL_DYNAMIC_DRAW);
+        glGenQueries(1, &slot.timerQuery);
+        m_freeSlotQueue.push_back(i);
+    }
+
+    // Initialize the readback ring, mapped once for the generator's whole lifetime
+    constexpr GLbitfield mapFlags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glCreateBuffers(1, &m_readbackBuffer);
+    glNamedBufferStorage(m_readbackBuffer, MAX_CONCURRENT_JOBS * bufferSize, nullptr, mapFlags);
+    m_readbackMapping = static_cast<const char *>(glMapNamedBufferRange(m_readbackBuffer, 0, MAX_CONCURRENT_JOBS * bufferSize, mapFlags));
+    if (!m_readbackMapping) {
+        std::cerr << "Error: GpuTerrainGenerator: Failed to map the readback buffer." << std::endl;
+        // The destructor does not run for a half-built generator, so free what was created so far.
+        releaseGlObjects();
+        throw std::runtime_error("Readback buffer mapping failed.");
+    }
+    for (int i = 0; i < MAX_CONCURRENT_JOBS; ++i)
+    {
+        m_freeReadSlotQueue.push_back(i);
+    }
+}
+
+// Destructor
+GpuTerrainGenerator::~GpuTerrainGenerator()
+{
+    releaseGlObjects();
+}
+
+// Deletes the compute program, the batch slots' buffers and queries, and the readback ring.
+void GpuTerrainGenerator::releaseGlObjects()
+{
+    glDeleteProgram(m_computeProgramID);
+    for (const auto &slot : m_slots)
+    {
+        glDeleteBuffers(1, &slot.ssbo);
+        glDeleteBuffers(1, &slot.coordsBuffer);
+        glDeleteBuffers(1, &slot.heightsBuffer);
+        glDeleteQueries(1, &slot.timerQuery);
+    }
+    if (m_readbackMapping)
+        glUnmapNamedBuffer(m_readbackBuffer);
+    glDeleteBuffers(1, &m_readbackBuffer);
+}
+
+// Tries to dispatch a new batch to the GPU.
+std::optional<GpuJob> GpuTerrainGenerator::dispatchJob(const std::vector<glm::ivec3> &chunkCoords,
+                                                      const std::vector<std::shared_ptr<const ColumnHeightmap>> &heightmaps)
+{
+    if (m_freeSlotQueue.empty() || chunkCoords.empty() || chunkCoords.size() > MAX_BATCH_SIZE || heightmaps.size() != chunkCoords.size())
+    {
+        return std::nullopt;
+    }
+
+    const size_t slotIndex = m_freeSlotQueue.front();
+    m_freeSlotQueue.pop_front();
+    const BatchSlot &slot = m_slots[slotIndex];
+
+    std::vector<glm::ivec4> coords;
+    coords.reserve(chunkCoords.size());
+    std::vector<int> heights(chunkCoords.size() * Constants::CHUNK_DIM * Constants::CHUNK_DIM);
+    for (size_t i = 0; i < chunkCoords.size(); ++i)
+    {
+        coords.emplace_back(chunkCoords[i], 0);
+        memcpy(&heights[i * Constants::CHUNK_DIM * Constants::CHUNK_DIM], heightmaps[i]->heights, sizeof(ColumnHeightmap::Heights));
+    }
+    glNamedBufferSubData(slot.coordsBuffer, 0, coords.size() * sizeof(glm::ivec4), coords.data());
+    glNamedBufferSubData(slot.heightsBuffer, 0, heights.size() * sizeof(int), heights.data());
+
+    // Reset the present-types headers; the shader only ever ORs into them.
+    glClearNamedBufferSubData(slot.ssbo, GL_R32UI, 0, chunkCoords.size() * sizeof(uint32_t), GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+
+    // Each chunk takes a 2x2x2 block of 8^3 workgroups, stacked along z.
+    constexpr GLuint groupsPerAxis = Constants::CHUNK_DIM / 8;
+    glUseProgram(m_computeProgramID);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, slot.ssbo);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, slot.coordsBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, slot.heightsBuffer);
+    glBeginQuery(GL_TIME_ELAPSED, slot.timerQuery);
+    glDispatchCompute(groupsPerAxis, groupsPerAxis, groupsPerAxis * static_cast<GLuint>(chunkCoords.size()));
+    glEndQuery(GL_TIME_ELAPSED);
+    GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    return GpuJob{chunkCoords, slotIndex, fence};
+}
+
+// Schedules a non-blocking copy from the finished batch's SSBO to a readback ring slot.
+std::optional<ReadbackJob> GpuTerrainGenerator::scheduleRead(const GpuJob& finishedJob)
+{
+    size_t slot;
+    {
+        std::lock_guard<std::mutex> lock(m_readSlotMutex);
+        if (m_freeReadSlotQueue.empty()) {
+            // Every slot is still being read, cannot schedule the read. Try again next frame.
+            return std::nullopt;
+        }
+        slot = m_freeReadSlotQueue.front();
+        m_freeReadSlotQueue.pop_front();
+    }
+
+    // Perform an asynchronous GPU-to-GPU copy of the headers and of the blocks actually generated.
+    const size_t copySize = BLOCKS_OFFSET + finishedJob.chunkCoords.size() * CHUNK_BLOCKS_SIZE;
+    glCopyNamedBufferSubData(m_slots[finishedJob.slot].ssbo, m_readbackBuffer, 0, slot * JOB_BUFFER_SIZE, copySize);
+
+    // Create a new fence that will be signaled when the copy operation completes.
+    // The mapping is coherent, so the data is visible to the CPU as soon as it has.
+    GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    return ReadbackJob{finishedJob.chunkCoords, slot, fence};
+}
+
+// Reads one chunk of a batch straight from the mapped readback ring.
+ChunkReadback GpuTerrainGenerator::readChunk(size_t slot, size_t index) const
+{
+    const char *batch = m_readbackMapping + slot * JOB_BUFFER_SIZE;
+    uint32_t presentTypes;
+    memcpy(&presentTypes, batch + index * sizeof(uint32_t), sizeof(uint32_t));
+
+    // Uniform chunks are fully described by their header.
+    if (std::has_single_bit(presentTypes))
+        return {presentTypes, nullptr};
+    return {presentTypes, reinterpret_cast<const BlockType *>(batch + BLOCKS_OFFSET + index * CHUNK_BLOCKS_SIZE)};
+}
+
+// Generates one chunk through the regular batch pipeline, blocking on each fence.
+uint32_t GpuTerrainGenerator::generateChunk(const glm::ivec3 &chunkCoord, BlockType *out)
+{
+    // A blocking tool path, so a missing column may as well be computed right here.
+    auto job = dispatchJob({chunkCoord}, {m_heightmaps.get(chunkCoord.x, chunkCoord.z)});
+    if (!job)
+    {
+        std::cerr << "Error: GpuTerrainGenerator: No free batch slot for a blocking generation." << std::endl;
+        throw std::runtime_error("No free batch slot.");
+    }
+    glClientWaitSync(job->fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+
+    auto readbackJob = scheduleRead(*job);
+    releaseGpuJob(*job);
+    if (!readbackJob)
+    {
+        std::cerr << "Error: GpuTerrainGenerator: No free readback slot for a blocking generation." << std::endl;
+        throw std::runtime_error("No free readback slot.");
+    }
+    glClientWaitSync(readbackJob->fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+    glDeleteSync(readbackJob->fence);
+
+    const ChunkReadback readback = readChunk(readbackJob->slot, 0);
+    if (readback.blocks)
+        memcpy(out, readback.blocks, CHUNK_BLOCKS_SIZE);
+    else
+        std::fill(out, out + Constants::CHUNK_VOL, static_cast<BlockType>(std::countr_zero(readback.presentTypes)));
+    releaseReadSlot(readbackJob->slot);
+    return readback.presentTypes;
+}
+
+// Folds the finished batch's GPU time into the per-chunk running average.
+void GpuTerrainGenerator::recordTiming(const BatchSlot &slot, size_t chunkCount)
+{
+    GLint available = 0;
+    glGetQueryObjectiv(slot.timerQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available || chunkCount == 0)
+    {
+        return;
+    }
+    GLuint64 elapsedNs = 0;
+    glGetQueryObjectui64v(slot.timerQuery, GL_QUERY_RESULT, &elapsedNs);
+    m_nsPerChunk = 0.8 * m_nsPerChunk + 0.2 * (static_cast<double>(elapsedNs) / chunkCount);
+}
+
+void GpuTerrainGenerator::releaseGpuJob(const GpuJob& job)
+{
+    recordTiming(m_slots[job.slot], job.chunkCoords.size());
+    glDeleteSync(job.fence);
+    m_freeSlotQueue.push_back(job.slot);
+}
+
+void GpuTerrainGenerator::releaseReadSlot(size_t slot)
+{
+    std::lock_guard<std::mutex> lock(m_readSlotMutex);
+    m_freeReadSlotQueue.push_back(slot);
+}
+
+ReadbackLease::~ReadbackLease()
+{
+    m_generator.releaseReadSlot(m_slot);
+}
+
+bool GpuTerrainGenerator::hasAvailableJobSlots() const
+{
+    return !m_freeSlotQueue.empty();
+}
+
+int GpuTerrainGenerator::getBatchSize() const
+{
+    const double chunks = FRAME_GPU_BUDGET_NS / std::max(m_nsPerChunk, 1.0);
+    return static_cast<int>(std::clamp(chunks, 1.0, static_cast<double>(MAX_BATCH_SIZE)));
+}
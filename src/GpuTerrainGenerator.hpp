@@ -0,0 +1,156 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <string_view>
+#include <cstdint>
+#include <vector>
+#include <deque>
+#include <optional>
+#include <mutex>
+#include "Constants.hpp"
+#include "Block.hpp"
+#include "TerrainGenerator.hpp"
+#include "HeightmapCache.hpp"
+
+// A structure to track an in-flight GPU generation batch.
+struct GpuJob
+{
+    std::vector<glm::ivec3> chunkCoords; // Chunk i of the batch is chunkCoords[i]
+    size_t slot;                         // The generator's batch slot holding the output
+    GLsync fence;
+};
+
+// A structure to track a pending asynchronous read-back of a whole batch into the readback ring.
+struct ReadbackJob
+{
+    std::vector<glm::ivec3> chunkCoords;
+    size_t slot; // The readback ring slot receiving the batch
+    GLsync fence;
+};
+
+// One generated chunk as seen in the readback ring.
+struct ChunkReadback
+{
+    uint32_t presentTypes;   // Bitset of the block types present (bit n = BlockType n)
+    const BlockType *blocks; // CHUNK_VOL blocks in x-major order, or nullptr for uniform chunks
+};
+
+class GpuTerrainGenerator;
+
+// Keeps a readback ring slot reserved while chunks are still being read from it, and returns the
+// slot to the generator when the last holder lets go. Safe to release from any thread.
+class ReadbackLease
+{
+public:
+    ReadbackLease(GpuTerrainGenerator &generator, size_t slot) : m_generator(generator), m_slot(slot) {}
+    ~ReadbackLease();
+
+    ReadbackLease(const ReadbackLease &) = delete;
+    ReadbackLease &operator=(const ReadbackLease &) = delete;
+
+    size_t getSlot() const { return m_slot; }
+
+private:
+    GpuTerrainGenerator &m_generator;
+    size_t m_slot;
+};
+
+// Manages the GPU-side terrain data generation using a compute shader. Must be used on the thread owning the GL context.
+// Chunks are generated in batches: one dispatch, one output buffer and one fence per batch.
+// Finished batches are copied into a persistently mapped readback ring that any thread can read.
+// Surface heights come from a HeightmapCache shared with the CPU generator and are uploaded with each batch.
+class GpuTerrainGenerator : public TerrainGenerator
+{
+public:
+    // The most chunks one batch can hold. Must match MAX_BATCH_SIZE in terrain_gen.comp.glsl.
+    static constexpr int MAX_BATCH_SIZE = 64;
+
+private:
+    // The buffers and timer query belonging to one in-flight batch.
+    struct BatchSlot
+    {
+        GLuint ssbo;         // Output: the present-types headers, then the blocks of each chunk
+        GLuint coordsBuffer; // Input: the chunk coordinates, as ivec4
+        GLuint heightsBuffer; // Input: the column heightmap of each chunk, CHUNK_DIM^2 ints each
+        GLuint timerQuery;   // GL_TIME_ELAPSED around the dispatch
+    };
+
+    GLuint m_computeProgramID;
+    HeightmapCache &m_heightmaps;
+
+    // A pool of batch slots to allow multiple batches to be in-flight simultaneously.
+    std::vector<BatchSlot> m_slots;
+    std::deque<size_t> m_freeSlotQueue;
+
+    // The readback ring: one persistently mapped, coherent buffer with one batch-sized slot per job.
+    GLuint m_readbackBuffer;
+    const char *m_readbackMapping;
+    // Slots are released by worker threads, so the free list is guarded.
+    std::deque<size_t> m_freeReadSlotQueue;
+    mutable std::mutex m_readSlotMutex;
+
+    // The maximum number of batches that can be in-flight on the GPU.
+    static constexpr int MAX_CONCURRENT_JOBS = 4;
+
+    // Each batch buffer starts with one uint per chunk: the bitset of the block types present in it.
+    // The blocks of chunk i follow at BLOCKS_OFFSET + i * CHUNK_BLOCKS_SIZE, one byte each (the shader
+    // packs four IDs per uint, lowest byte first), so on a little-endian host they read back as BlockType directly.
+    static constexpr size_t HEADER_SIZE = MAX_BATCH_SIZE * sizeof(uint32_t);
+    static constexpr size_t BLOCKS_OFFSET = HEADER_SIZE;
+    static constexpr size_t CHUNK_BLOCKS_SIZE = Constants::CHUNK_VOL * sizeof(BlockType);
+    static constexpr size_t JOB_BUFFER_SIZE = BLOCKS_OFFSET + MAX_BATCH_SIZE * CHUNK_BLOCKS_SIZE;
+
+    // How much GPU time per frame the generation dispatch may take; the batch size adapts to it.
+    static constexpr double FRAME_GPU_BUDGET_NS = 2'000'000.0;
+
+    // Running average of the measured GPU time per generated chunk.
+    double m_nsPerChunk = 100'000.0;
+
+    void recordTiming(const BatchSlot &slot, size_t chunkCount);
+    void releaseGlObjects();
+
+public:
+    // The heightmaps must have been computed with the same seed.
+    GpuTerrainGenerator(std::string_view computeSrc, HeightmapCache &heightmaps, uint32_t seed);
+    ~GpuTerrainGenerator();
+
+    GpuTerrainGenerator(const GpuTerrainGenerator &) = delete;
+    GpuTerrainGenerator &operator=(const GpuTerrainGenerator &) = delete;
+
+    // Generates a single chunk and waits for the result. Stalls the pipeline; meant for tools and
+    // verification rather than streaming. Throws if every batch or readback slot is in use.
+    uint32_t generateChunk(const glm::ivec3 &chunkCoord, BlockType *out) override;
+
+    /**
+     * @brief Dispatches one compute job generating every chunk in `chunkCoords` (at most MAX_BATCH_SIZE).
+     * @param chunkCoords The chunks to generate.
+     * @param heightmaps The heightmap of each chunk's column, indexed alike. Passing them in keeps the
+     *        (expensive) surface noise off the calling thread, which is the one owning the GL context.
+     */
+    std::optional<GpuJob> dispatchJob(const std::vector<glm::ivec3> &chunkCoords,
+                                      const std::vector<std::shared_ptr<const ColumnHeightmap>> &heightmaps);
+    
+    // Schedules a non-blocking copy from the finished batch's SSBO to a readback ring slot.
+    std::optional<ReadbackJob> scheduleRead(const GpuJob& finishedJob);
+
+    /**
+     * @brief Reads one chunk of a batch straight from the mapped readback ring. Thread-safe.
+     * @details Only valid once the read-back fence has signaled, and until the slot is released.
+     * @param slot The readback ring slot holding the batch.
+     * @param index The chunk's index in the batch.
+     */
+    ChunkReadback readChunk(size_t slot, size_t index) const;
+
+    // Releases resources for a finished GPU compute job, recording its GPU time.
+    void releaseGpuJob(const GpuJob& job);
+    
+    // Returns a readback ring slot to the pool. Thread-safe.
+    void releaseReadSlot(size_t slot);
+
+    // Checks if there are free slots to dispatch new batches.
+    bool hasAvailableJobSlots() const;
+
+    // The number of chunks the next batch should hold to stay within the per-frame GPU budget.
+    int getBatchSize() const;
+};
@@ -0,0 +1,57 @@
+#include "HeightmapCache.hpp"
+#include <algorithm>
+
+HeightmapCache::HeightmapCache(size_t capacity, Filler filler)
+    : m_capacity(std::max<size_t>(capacity, 1)), m_filler(std::move(filler))
+{
+    m_index.reserve(m_capacity + 1);
+}
+
+std::shared_ptr<const ColumnHeightmap> HeightmapCache::get(int columnX, int columnZ)
+{
+    const uint64_t key = packColumn(columnX, columnZ);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_index.find(key);
+        if (it != m_index.end())
+        {
+            m_lru.splice(m_lru.begin(), m_lru, it->second);
+            return it->second->heightmap;
+        }
+    }
+
+    // Compute outside the lock so other columns can be served meanwhile. Two threads missing the
+    // same column both compute it; the heights are identical, and the first one inserted wins.
+    auto heightmap = std::make_shared<ColumnHeightmap>();
+    m_filler(columnX * Constants::CHUNK_DIM, columnZ * Constants::CHUNK_DIM, heightmap->heights);
+    const auto [minIt, maxIt] = std::minmax_element(&heightmap->heights[0][0], &heightmap->heights[0][0] + Constants::CHUNK_DIM * Constants::CHUNK_DIM);
+    heightmap->minHeight = *minIt;
+    heightmap->maxHeight = *maxIt;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto [it, inserted] = m_index.try_emplace(key);
+    if (!inserted)
+    {
+        m_lru.splice(m_lru.begin(), m_lru, it->second);
+        return it->second->heightmap;
+    }
+    m_lru.push_front(Node{key, heightmap});
+    it->second = m_lru.begin();
+
+    if (m_lru.size() > m_capacity)
+    {
+        m_index.erase(m_lru.back().key);
+        m_lru.pop_back();
+    }
+    return heightmap;
+}
+
+std::shared_ptr<const ColumnHeightmap> HeightmapCache::find(int columnX, int columnZ)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_index.find(packColumn(columnX, columnZ));
+    if (it == m_index.end())
+        return nullptr;
+    m_lru.splice(m_lru.begin(), m_lru, it->second);
+    return it->second->heightmap;
+}
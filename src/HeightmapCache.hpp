@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include "Constants.hpp"
+
+// The terrain surface heights of one chunk column, shared by every chunk stacked in it.
+struct ColumnHeightmap
+{
+    using Heights = int[Constants::CHUNK_DIM][Constants::CHUNK_DIM];
+
+    Heights heights; // Indexed [x][z], in world block units
+    int minHeight;   // The lowest surface in the column
+    int maxHeight;   // The highest surface in the column
+};
+
+/**
+ * @class HeightmapCache
+ * @brief A thread-safe, LRU-bounded cache of column heightmaps keyed by chunk column (chunk x, chunk z).
+ *
+ * The surface height only depends on x and z, so it is computed once per column instead of once per
+ * block and per vertically stacked chunk. Heightmaps are handed out as shared pointers, so an entry
+ * evicted while a generator is still using it stays valid for that generator.
+ */
+class HeightmapCache
+{
+public:
+    // Fills the heights of the column whose first block is at (baseX, baseZ).
+    using Filler = std::function<void(int baseX, int baseZ, ColumnHeightmap::Heights &heights)>;
+
+    HeightmapCache(size_t capacity, Filler filler);
+
+    HeightmapCache(const HeightmapCache &) = delete;
+    HeightmapCache &operator=(const HeightmapCache &) = delete;
+
+    /**
+     * @brief Returns the heightmap of a chunk column, computing it on a miss.
+     * @param columnX The chunk x coordinate of the column.
+     * @param columnZ The chunk z coordinate of the column.
+     */
+    std::shared_ptr<const ColumnHeightmap> get(int columnX, int columnZ);
+
+    /**
+     * @brief Returns the heightmap of a chunk column if it is cached, never computing it.
+     * @param columnX The chunk x coordinate of the column.
+     * @param columnZ The chunk z coordinate of the column.
+     * @return The heightmap, or nullptr on a miss.
+     */
+    std::shared_ptr<const ColumnHeightmap> find(int columnX, int columnZ);
+
+private:
+    struct Node
+    {
+        uint64_t key;
+        std::shared_ptr<const ColumnHeightmap> heightmap;
+    };
+
+    static uint64_t packColumn(int columnX, int columnZ)
+    {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(columnX)) << 32) | static_cast<uint32_t>(columnZ);
+    }
+
+    size_t m_capacity;
+    Filler m_filler;
+
+    // Most recently used first; the index points into the list.
+    std::list<Node> m_lru;
+    std::unordered_map<uint64_t, std::list<Node>::iterator> m_index;
+    mutable std::mutex m_mutex;
+};
@@ -7,18 +7,18 @@ struct MeshAllocation
 {
     // The index of the buffer pool this mesh belongs to.
     uint32_t poolIndex = 0;
-    // The offset (in vertices) from the beginning of the VBO.
-    uint32_t vertexOffset = 0;
-    // The offset (in indices) from the beginning of the EBO.
-    uint32_t indexOffset = 0;
-    // The number of vertices in this mesh.
-    uint32_t vertexCount = 0;
-    // The number of indices in this mesh.
-    uint32_t indexCount = 0;
+    // The offset (in quads) from the beginning of the pool's quad buffer.
+    uint32_t quadOffset = 0;
+    // The number of quads in this mesh.
+    uint32_t quadCount = 0;
+    // The mesh's record for GPU culling (see ChunkRenderer::addCulledMesh), or NO_CULL_SLOT.
+    uint32_t cullSlot = NO_CULL_SLOT;
+
+    static constexpr uint32_t NO_CULL_SLOT = UINT32_MAX;
 
     // Checks if the allocation is valid (i.e., has something to draw).
     bool isValid() const
     {
-        return indexCount > 0 && vertexCount > 0;
+        return quadCount > 0;
     }
 };
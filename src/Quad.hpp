@@ -0,0 +1,30 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+
+// One greedy quad of a chunk mesh, packed into two 32-bit words. The mesher emits one per quad into
+// the pool's quad buffer, and core.vert.glsl expands it into its four corners from gl_VertexID.
+// Every field is a small integer: the chunk-local origin is 0-16, the normal is one of six faces,
+// each side spans 1-16 blocks and the texture is an atlas tile index.
+// Quads are the only mesh format: they replaced the packed per-vertex format (Vertex) outright, and
+// there is no vertex-attribute path to select instead.
+struct Quad
+{
+    // x (bits 0-4) | y (5-9) | z (10-14) | face (15-17) | size along u - 1 (18-21) | size along v - 1 (22-25).
+    // The face is axis * 2, plus 1 for the positive direction; u and v are the next two axes after it.
+    uint32_t geometry;      // 4 bytes
+    // The atlas tile index (bits 0-15). The upper bits are reserved.
+    uint32_t texture;       // 4 bytes
+    // Total: 8 bytes, against 4 vertices and 6 indices (44 bytes) for an indexed quad.
+
+    static Quad pack(const glm::ivec3 &origin, int face, int sizeU, int sizeV, uint32_t tile)
+    {
+        return Quad{
+            static_cast<uint32_t>(origin.x) | static_cast<uint32_t>(origin.y) << 5 | static_cast<uint32_t>(origin.z) << 10 |
+                static_cast<uint32_t>(face) << 15 | static_cast<uint32_t>(sizeU - 1) << 18 | static_cast<uint32_t>(sizeV - 1) << 22,
+            tile & 0xFFFFu};
+    }
+};
+
+static_assert(sizeof(Quad) == 8, "Quad must stay two packed words; the shader reads it as a uvec2.");
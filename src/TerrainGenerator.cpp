@@ -1,144 +1,112 @@
 #include "TerrainGenerator.hpp"
-#include "Constants.hpp"
-#include <iostream>
-#include <stdexcept>
-#include <cstring> // Required for memcpy
+#include <cmath>
+#include <bit>
 
-// Constructor
-TerrainGenerator::TerrainGenerator(std::string_view computeSrc)
-{
-    GLuint computeShader = glCreateShader(GL_COMPUTE_SHADER);
-    const char *srcData = computeSrc.data();
-    GLint srcLength = static_cast<GLint>(computeSrc.size());
-    glShaderSource(computeShader, 1, &srcData, &srcLength);
-    glCompileShader(computeShader);
-    GLint success;
-    glGetShaderiv(computeShader, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        GLchar infoLog[512];
-        glGetShaderInfoLog(computeShader, 512, NULL, infoLog);
-        std::cerr << "Error: TerrainGenerator: Compute shader compilation failed:\n" << infoLog << std::endl;
-        throw std::runtime_error("Compute shader compilation failed.");
-    }
-
-    m_computeProgramID = glCreateProgram();
-    glAttachShader(m_computeProgramID, computeShader);
-    glLinkProgram(m_computeProgramID);
-    glGetProgramiv(m_computeProgramID, GL_LINK_STATUS, &success);
-    if (!success) {
-        GLchar infoLog[512];
-        glGetProgramInfoLog(m_computeProgramID, 512, NULL, infoLog);
-        std::cerr << "Error: TerrainGenerator: Compute program linking failed:\n" << infoLog << std::endl;
-        glDeleteShader(computeShader);
-        throw std::runtime_error("Compute program linking failed.");
-    }
-    glDeleteShader(computeShader);
-
-    constexpr size_t bufferSize = Constants::CHUNK_VOL * sizeof(uint32_t);
+// These functions rely on every float operation being rounded on its own: the build must not
+// contract a * b + c into an FMA (GCC's default in ISO C++ mode, -ffp-contract=off).
 
-    // Initialize SSBO pool for compute shaders
-    m_ssboPool.resize(MAX_CONCURRENT_JOBS);
-    glGenBuffers(MAX_CONCURRENT_JOBS, m_ssboPool.data());
-    for (int i = 0; i < MAX_CONCURRENT_JOBS; ++i)
+namespace
+{
+    float grad2(uint32_t h, float dx, float dz)
     {
-        glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_ssboPool[i]);
-        glBufferData(GL_SHADER_STORAGE_BUFFER, bufferSize, nullptr, GL_DYNAMIC_DRAW);
-        m_freeSsboQueue.push_back(m_ssboPool[i]);
+        return ((h & 1u) ? -dx : dx) + ((h & 2u) ? -dz : dz);
     }
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 
-    // Initialize PBO pool for asynchronous read-back
-    m_pboPool.resize(MAX_CONCURRENT_JOBS);
-    glGenBuffers(MAX_CONCURRENT_JOBS, m_pboPool.data());
-    for (int i = 0; i < MAX_CONCURRENT_JOBS; ++i)
+    float grad3(uint32_t h, float dx, float dy, float dz)
     {
-        glBindBuffer(GL_PIXEL_PACK_BUFFER, m_pboPool[i]);
-        glBufferData(GL_PIXEL_PACK_BUFFER, bufferSize, nullptr, GL_STREAM_READ);
-        m_freePboQueue.push_back(m_pboPool[i]);
+        h &= 15u;
+        const float u = h < 8u ? dx : dy;
+        const float v = h < 4u ? dy : (h == 12u || h == 14u) ? dx : dz;
+        return ((h & 1u) ? -u : u) + ((h & 2u) ? -v : v);
     }
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
 }
 
-// Destructor
-TerrainGenerator::~TerrainGenerator()
+float TerrainGenerator::gradientNoise2D(float x, float z, uint32_t seed)
 {
-    glDeleteProgram(m_computeProgramID);
-    glDeleteBuffers(m_ssboPool.size(), m_ssboPool.data());
-    glDeleteBuffers(m_pboPool.size(), m_pboPool.data());
-}
-
-// Tries to dispatch a new job to the GPU.
-std::optional<GpuJob> TerrainGenerator::dispatchJob(const glm::ivec3 &chunkCoord)
-{
-    if (m_freeSsboQueue.empty())
-    {
-        return std::nullopt;
-    }
-
-    GLuint ssbo = m_freeSsboQueue.front();
-    m_freeSsboQueue.pop_front();
-
-    glUseProgram(m_computeProgramID);
-    glUniform3i(glGetUniformLocation(m_computeProgramID, "u_chunkCoord"), chunkCoord.x, chunkCoord.y, chunkCoord.z);
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, ssbo);
-    glDispatchCompute(Constants::CHUNK_DIM / 8, Constants::CHUNK_DIM / 8, Constants::CHUNK_DIM / 8);
-    GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
-
-    return GpuJob{chunkCoord, ssbo, fence};
+    const float x0 = std::floor(x);
+    const float z0 = std::floor(z);
+    const int ix = static_cast<int>(x0);
+    const int iz = static_cast<int>(z0);
+    const float fx = x - x0;
+    const float fz = z - z0;
+
+    const float n00 = grad2(hash(ix, 0, iz, seed), fx, fz);
+    const float n10 = grad2(hash(ix + 1, 0, iz, seed), fx - 1.0f, fz);
+    const float n01 = grad2(hash(ix, 0, iz + 1, seed), fx, fz - 1.0f);
+    const float n11 = grad2(hash(ix + 1, 0, iz + 1, seed), fx - 1.0f, fz - 1.0f);
+
+    const float u = fade(fx);
+    const float v = fade(fz);
+    return lerp(lerp(n00, n10, u), lerp(n01, n11, u), v);
 }
 
-// Schedules a non-blocking copy from the finished job's SSBO to a PBO.
-std::optional<PboReadJob> TerrainGenerator::scheduleRead(const GpuJob& finishedJob)
+float TerrainGenerator::gradientNoise3D(float x, float y, float z, uint32_t seed)
 {
-    if (m_freePboQueue.empty()) {
-        // PBO pool is full, cannot schedule the read. Try again next frame.
-        return std::nullopt;
-    }
-    GLuint pbo = m_freePboQueue.front();
-    m_freePboQueue.pop_front();
-
-    // Perform an asynchronous GPU-to-GPU copy.
-    glBindBuffer(GL_COPY_READ_BUFFER, finishedJob.ssbo);
-    glBindBuffer(GL_COPY_WRITE_BUFFER, pbo);
-    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, Constants::CHUNK_VOL * sizeof(uint32_t));
-    glBindBuffer(GL_COPY_READ_BUFFER, 0);
-    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
-
-    // Create a new fence that will be signaled when the copy operation completes.
-    GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
-
-    return PboReadJob{finishedJob.chunkCoord, pbo, fence};
+    const float x0 = std::floor(x);
+    const float y0 = std::floor(y);
+    const float z0 = std::floor(z);
+    const int ix = static_cast<int>(x0);
+    const int iy = static_cast<int>(y0);
+    const int iz = static_cast<int>(z0);
+    const float fx = x - x0;
+    const float fy = y - y0;
+    const float fz = z - z0;
+
+    const float n000 = grad3(hash(ix, iy, iz, seed), fx, fy, fz);
+    const float n100 = grad3(hash(ix + 1, iy, iz, seed), fx - 1.0f, fy, fz);
+    const float n010 = grad3(hash(ix, iy + 1, iz, seed), fx, fy - 1.0f, fz);
+    const float n110 = grad3(hash(ix + 1, iy + 1, iz, seed), fx - 1.0f, fy - 1.0f, fz);
+    const float n001 = grad3(hash(ix, iy, iz + 1, seed), fx, fy, fz - 1.0f);
+    const float n101 = grad3(hash(ix + 1, iy, iz + 1, seed), fx - 1.0f, fy, fz - 1.0f);
+    const float n011 = grad3(hash(ix, iy + 1, iz + 1, seed), fx, fy - 1.0f, fz - 1.0f);
+    const float n111 = grad3(hash(ix + 1, iy + 1, iz + 1, seed), fx - 1.0f, fy - 1.0f, fz - 1.0f);
+
+    const float u = fade(fx);
+    const float v = fade(fy);
+    const float w = fade(fz);
+    const float nx00 = lerp(n000, n100, u);
+    const float nx10 = lerp(n010, n110, u);
+    const float nx01 = lerp(n001, n101, u);
+    const float nx11 = lerp(n011, n111, u);
+    return lerp(lerp(nx00, nx10, v), lerp(nx01, nx11, v), w);
 }
 
-// Reads data from a PBO that has finished its transfer.
-void TerrainGenerator::readPboData(const PboReadJob& job, uint32_t* out_blockData)
+int TerrainGenerator::surfaceHeight(int worldX, int worldZ, uint32_t seed)
 {
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, job.pbo);
-    // Map the buffer. Since we waited for the fence, this should not stall.
-    void* ptr = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, Constants::CHUNK_VOL * sizeof(uint32_t), GL_MAP_READ_BIT);
-    if (ptr) {
-        memcpy(out_blockData, ptr, Constants::CHUNK_VOL * sizeof(uint32_t));
-        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
-    } else {
-        std::cerr << "Error: glMapBufferRange failed for PBO " << job.pbo << std::endl;
-        // As a fallback, a robust implementation could fill the output buffer with default data (e.g., AIR blocks).
+    // Sample at the block centre. Doubling and halving are exact, so every backend steps the octaves identically.
+    const float x = static_cast<float>(worldX) + 0.5f;
+    const float z = static_cast<float>(worldZ) + 0.5f;
+    float frequency = HEIGHT_FREQUENCY;
+    float amplitude = HEIGHT_AMPLITUDE;
+    float height = 0.0f;
+    for (int octave = 0; octave < HEIGHT_OCTAVES; ++octave)
+    {
+        height = height + amplitude * gradientNoise2D(x * frequency, z * frequency, octaveSeed(seed, octave));
+        frequency = frequency * 2.0f;
+        amplitude = amplitude * 0.5f;
     }
-    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
-}
-
-void TerrainGenerator::releaseGpuJob(const GpuJob& job)
-{
-    glDeleteSync(job.fence);
-    m_freeSsboQueue.push_back(job.ssbo);
+    return static_cast<int>(std::floor(height));
 }
 
-void TerrainGenerator::releasePboJob(const PboReadJob& job)
+float TerrainGenerator::latticeSample(int latticeX, int latticeY, int latticeZ, float frequency, uint32_t seed)
 {
-    glDeleteSync(job.fence);
-    m_freePboQueue.push_back(job.pbo);
+    // Sampled half a block off the lattice point, never on a noise lattice point (where gradient noise is always zero).
+    return gradientNoise3D((static_cast<float>(latticeX * DENSITY_LATTICE_SPACING) + 0.5f) * frequency,
+                           (static_cast<float>(latticeY * DENSITY_LATTICE_SPACING) + 0.5f) * frequency,
+                           (static_cast<float>(latticeZ * DENSITY_LATTICE_SPACING) + 0.5f) * frequency,
+                           seed);
 }
 
-bool TerrainGenerator::hasAvailableJobSlots() const
+float TerrainGenerator::latticeDensity(int worldX, int worldY, int worldZ, float frequency, uint32_t seed)
 {
-    return !m_freeSsboQueue.empty();
+    // Arithmetic shifts floor, so negative coordinates land in the right cell.
+    constexpr int shift = std::countr_zero(static_cast<unsigned>(DENSITY_LATTICE_SPACING));
+    const int lx = worldX >> shift;
+    const int ly = worldY >> shift;
+    const int lz = worldZ >> shift;
+    return trilinear(latticeSample(lx, ly, lz, frequency, seed), latticeSample(lx + 1, ly, lz, frequency, seed),
+                     latticeSample(lx, ly + 1, lz, frequency, seed), latticeSample(lx + 1, ly + 1, lz, frequency, seed),
+                     latticeSample(lx, ly, lz + 1, frequency, seed), latticeSample(lx + 1, ly, lz + 1, frequency, seed),
+                     latticeSample(lx, ly + 1, lz + 1, frequency, seed), latticeSample(lx + 1, ly + 1, lz + 1, frequency, seed),
+                     latticeWeight(worldX), latticeWeight(worldY), latticeWeight(worldZ));
 }
@@ -1,68 +1,193 @@
 #pragma once
 
-#include <GL/glew.h>
-#include <glm/glm.hpp>
-#include <string_view>
 #include <cstdint>
-#include <vector>
-#include <deque>
+#include <cmath>
 #include <optional>
+#include <glm/glm.hpp>
+#include "Block.hpp"
+#include "Constants.hpp"
 
-// A structure to track an in-flight GPU generation job.
-struct GpuJob
+/**
+ * @class TerrainGenerator
+ * @brief The interface shared by the terrain generation backends (GpuTerrainGenerator, CpuTerrainGenerator).
+ *
+ * The terrain is seeded gradient noise: a multi-octave 2D heightmap shapes the surface, and 3D noise
+ * adds overhangs in a band above it and carves caves in a band below it. The 3D noise is sampled on a
+ * coarse lattice (every DENSITY_LATTICE_SPACING blocks, shared by neighbouring chunks) and trilinearly
+ * interpolated to the blocks, instead of evaluating up to 8192 noise samples per chunk (two fields per
+ * block). The CPU generator samples a chunk's 5x5x5 lattice once per field it needs, at most 375
+ * evaluations (~22x fewer). terrain_gen.comp.glsl samples all three fields on the 3x3x3 lattice of each
+ * of a chunk's eight 8^3 workgroups, re-evaluating the shared points: 648 evaluations (~12.6x fewer).
+ * The scalar functions below are the reference definition of the terrain. Every backend produces
+ * exactly the same blocks for a given seed and chunk: surface heights are only ever computed on the
+ * CPU (the SIMD paths use the same IEEE operations in the same order as surfaceHeight) and cached per
+ * column, and terrain_gen.comp.glsl mirrors the 3D density functions operation for operation (marked
+ * `precise`, so nothing is reordered or fused into FMAs). Only multiplies, adds and floor are used,
+ * which are exact-rounded everywhere.
+ */
+class TerrainGenerator
 {
-    glm::ivec3 chunkCoord;
-    GLuint ssbo;
-    GLsync fence;
-};
+public:
+    virtual ~TerrainGenerator() = default;
 
-// A structure to track a pending asynchronous read-back via a PBO.
-struct PboReadJob
-{
-    glm::ivec3 chunkCoord;
-    GLuint pbo;
-    GLsync fence;
-};
+    /**
+     * @brief Generates the blocks of one chunk, blocking until they are ready.
+     * @param chunkCoord The coordinate of the chunk.
+     * @param out Receives CHUNK_VOL blocks in x-major order.
+     * @return The bitset of block types present in the chunk (bit n = BlockType n).
+     */
+    virtual uint32_t generateChunk(const glm::ivec3 &chunkCoord, BlockType *out) = 0;
 
-// Manages the GPU-side terrain data generation using a compute shader.
-class TerrainGenerator
-{
-private:
-    GLuint m_computeProgramID;
+    uint32_t getSeed() const { return m_seed; }
 
-    // A pool of buffers to allow multiple jobs to be in-flight simultaneously.
-    std::vector<GLuint> m_ssboPool;
-    std::deque<GLuint> m_freeSsboQueue;
+    // --- Reference terrain functions ---
 
-    // A pool of PBOs for asynchronous read-back of chunk data.
-    std::vector<GLuint> m_pboPool;
-    std::deque<GLuint> m_freePboQueue;
+    // A well-mixed 32-bit hash of an integer lattice point.
+    static uint32_t hash(int x, int y, int z, uint32_t seed)
+    {
+        uint32_t h = seed ^ (static_cast<uint32_t>(x) * 0x8da6b343u) ^ (static_cast<uint32_t>(y) * 0xd8163841u) ^ (static_cast<uint32_t>(z) * 0xcb1ab31fu);
+        h ^= h >> 16;
+        h *= 0x7feb352du;
+        h ^= h >> 15;
+        h *= 0x846ca68bu;
+        h ^= h >> 16;
+        return h;
+    }
 
-    // The maximum number of chunk generations that can be in-flight on the GPU.
-    static constexpr int MAX_CONCURRENT_JOBS = 64;
+    // The seed of noise octave (or layer) `octave`.
+    static uint32_t octaveSeed(uint32_t seed, int octave) { return seed + static_cast<uint32_t>(octave) * 0x9e3779b9u; }
 
-public:
-    TerrainGenerator(std::string_view computeSrc);
-    ~TerrainGenerator();
+    // 2D gradient noise in about [-1, 1], with diagonal gradients picked by the lattice hash.
+    static float gradientNoise2D(float x, float z, uint32_t seed);
+
+    // 3D gradient noise in about [-1, 1], with Perlin's twelve edge gradients.
+    static float gradientNoise3D(float x, float y, float z, uint32_t seed);
+
+    // The terrain surface height of the block column at (worldX, worldZ): HEIGHT_OCTAVES octaves of 2D noise.
+    static int surfaceHeight(int worldX, int worldZ, uint32_t seed);
+
+    // The block at height worldY in a column whose surface is at surfaceY, before any 3D shaping.
+    static BlockType blockAt(int worldY, int surfaceY)
+    {
+        if (worldY > surfaceY)
+            return BlockType::AIR;
+        if (worldY == surfaceY)
+            return BlockType::GRASS;
+        if (worldY > surfaceY - DIRT_DEPTH - 1) // DIRT_DEPTH layers of dirt
+            return BlockType::DIRT;
+        return BlockType::STONE; // Everything below is stone
+    }
+
+    // Whether the 3D density can change the block at worldY in a column whose surface is at surfaceY.
+    static bool isInDensityBand(int worldY, int surfaceY)
+    {
+        return worldY > surfaceY - CAVE_DEPTH && worldY <= surfaceY + OVERHANG_HEIGHT;
+    }
+
+    // The final block at a world position in a column whose surface is at surfaceY.
+    static BlockType terrainBlock(int worldX, int worldY, int worldZ, int surfaceY, uint32_t seed)
+    {
+        if (!isInDensityBand(worldY, surfaceY))
+            return blockAt(worldY, surfaceY);
+        if (worldY > surfaceY)
+        {
+            const float density = latticeDensity(worldX, worldY, worldZ, OVERHANG_FREQUENCY, octaveSeed(seed, OVERHANG_SEED_LAYER));
+            return isOverhang(density, worldY - surfaceY) ? BlockType::STONE : BlockType::AIR;
+        }
+        const float caveA = latticeDensity(worldX, worldY, worldZ, CAVE_FREQUENCY, octaveSeed(seed, CAVE_SEED_LAYER));
+        const float caveB = latticeDensity(worldX, worldY, worldZ, CAVE_FREQUENCY, octaveSeed(seed, CAVE_SEED_LAYER + 1));
+        return isCave(caveA, caveB) ? BlockType::AIR : blockAt(worldY, surfaceY);
+    }
+
+    // A 3D noise field at lattice point (latticeX, latticeY, latticeZ), i.e. at block DENSITY_LATTICE_SPACING times that.
+    static float latticeSample(int latticeX, int latticeY, int latticeZ, float frequency, uint32_t seed);
+
+    // A 3D noise field at a block, interpolated from the eight lattice samples around it.
+    static float latticeDensity(int worldX, int worldY, int worldZ, float frequency, uint32_t seed);
+
+    // The interpolation weight of a block within its lattice cell along one axis.
+    static float latticeWeight(int worldCoord)
+    {
+        return static_cast<float>(worldCoord & (DENSITY_LATTICE_SPACING - 1)) * (1.0f / DENSITY_LATTICE_SPACING);
+    }
+
+    // Trilinear interpolation of a lattice cell's corners (cXYZ), along x first, then y, then z.
+    static float trilinear(float c000, float c100, float c010, float c110, float c001, float c101, float c011, float c111,
+                           float tx, float ty, float tz)
+    {
+        const float x00 = lerp(c000, c100, tx);
+        const float x10 = lerp(c010, c110, tx);
+        const float x01 = lerp(c001, c101, tx);
+        const float x11 = lerp(c011, c111, tx);
+        return lerp(lerp(x00, x10, ty), lerp(x01, x11, ty), tz);
+    }
+
+    // Whether a block `heightAboveSurface` (1 to OVERHANG_HEIGHT) blocks above the surface is solid rock.
+    static bool isOverhang(float density, int heightAboveSurface)
+    {
+        return density > OVERHANG_THRESHOLD + static_cast<float>(heightAboveSurface) * OVERHANG_FALLOFF;
+    }
+
+    // Whether a block below the surface (within CAVE_DEPTH of it) is carved out by a cave tunnel.
+    static bool isCave(float caveA, float caveB)
+    {
+        return std::fabs(caveA) < CAVE_RADIUS && std::fabs(caveB) < CAVE_RADIUS;
+    }
+
+    /**
+     * @brief Classifies a chunk from the surface bounds of its column, without generating any block.
+     * @param chunkY The chunk's y coordinate.
+     * @param minSurface The lowest surface height in the chunk's column.
+     * @param maxSurface The highest surface height in the chunk's column.
+     * @return The single block type filling the chunk, or nullopt if it may hold several.
+     */
+    static std::optional<BlockType> uniformBlockType(int chunkY, int minSurface, int maxSurface)
+    {
+        const int bottomY = chunkY * Constants::CHUNK_DIM;
+        const int topY = bottomY + Constants::CHUNK_DIM - 1;
+        if (bottomY > maxSurface + OVERHANG_HEIGHT) // Above any overhang
+            return BlockType::AIR;
+        if (topY <= minSurface - CAVE_DEPTH) // Below any cave, and so below the dirt layers too
+            return BlockType::STONE;
+        return std::nullopt;
+    }
+
+    // --- Terrain shape parameters. The 3D ones must match terrain_gen.comp.glsl. ---
+
+    // Surface: HEIGHT_OCTAVES octaves of 2D noise, each at twice the frequency and half the amplitude of the last.
+    static constexpr int HEIGHT_OCTAVES = 5;
+    static constexpr float HEIGHT_FREQUENCY = 1.0f / 256.0f; // Of the first octave, per block
+    static constexpr float HEIGHT_AMPLITUDE = 48.0f;         // Of the first octave, in blocks
+    static constexpr int DIRT_DEPTH = 3;
+
+    // The 3D noise fields are sampled every DENSITY_LATTICE_SPACING blocks along each axis.
+    static constexpr int DENSITY_LATTICE_SPACING = 4;
+    // The lattice points along one axis of a chunk, including those shared with the next chunk.
+    static constexpr int DENSITY_LATTICE_DIM = Constants::CHUNK_DIM / DENSITY_LATTICE_SPACING + 1;
+
+    // Overhangs: rock above the surface where 3D noise exceeds a threshold rising with the height.
+    static constexpr int OVERHANG_HEIGHT = 10;
+    static constexpr float OVERHANG_FREQUENCY = 1.0f / 16.0f;
+    static constexpr float OVERHANG_THRESHOLD = 0.4f;  // At the surface
+    static constexpr float OVERHANG_FALLOFF = 0.06f;   // Per block above it, so OVERHANG_HEIGHT reaches 1.0
+    static constexpr int OVERHANG_SEED_LAYER = 16;
 
-    TerrainGenerator(const TerrainGenerator &) = delete;
-    TerrainGenerator &operator=(const TerrainGenerator &) = delete;
+    // Caves: tunnels where two 3D noise fields are both near zero, down to CAVE_DEPTH below the surface.
+    static constexpr int CAVE_DEPTH = 40;
+    static constexpr float CAVE_FREQUENCY = 1.0f / 32.0f;
+    static constexpr float CAVE_RADIUS = 0.1f;
+    static constexpr int CAVE_SEED_LAYER = 17; // And 18 for the second field
 
-    // Dispatches a new compute job to the GPU.
-    std::optional<GpuJob> dispatchJob(const glm::ivec3 &chunkCoord);
-    
-    // Schedules a non-blocking copy from the finished job's SSBO to a PBO.
-    std::optional<PboReadJob> scheduleRead(const GpuJob& finishedJob);
+    static_assert(CAVE_DEPTH > DIRT_DEPTH, "uniformBlockType assumes caves reach below the dirt layers.");
+    static_assert(Constants::CHUNK_DIM % DENSITY_LATTICE_SPACING == 0 && (DENSITY_LATTICE_SPACING & (DENSITY_LATTICE_SPACING - 1)) == 0,
+                  "The density lattice must be a power of two dividing the chunk size.");
 
-    // Reads data from a PBO that has finished its transfer.
-    void readPboData(const PboReadJob& job, uint32_t* out_blockData);
+protected:
+    explicit TerrainGenerator(uint32_t seed) : m_seed(seed) {}
 
-    // Releases resources for a finished GPU compute job.
-    void releaseGpuJob(const GpuJob& job);
-    
-    // Releases resources for a finished PBO read-back job.
-    void releasePboJob(const PboReadJob& job);
+    uint32_t m_seed;
 
-    // Checks if there are free SSBOs to dispatch new jobs.
-    bool hasAvailableJobSlots() const;
+    // Perlin's quintic fade curve, as evaluated by every backend.
+    static float fade(float t) { return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f); }
+    static float lerp(float a, float b, float t) { return a + t * (b - a); }
 };
@@ -12,7 +12,7 @@
 #include <algorithm> 
 
 // Constructor
-TextureManager::TextureManager() : m_atlasTextureID(0), m_atlasWidth(0), m_atlasHeight(0) {}
+TextureManager::TextureManager() : m_atlasTextureID(0), m_atlasWidth(0), m_atlasHeight(0), m_tilesPerRow(1) {}
 
 // Destructor
 TextureManager::~TextureManager() {
@@ -70,6 +70,7 @@ void TextureManager::loadAndStitch() {
     const int texSize = Constants::TEXTURE_SIZE_PX; 
     int texturesPerRow = std::max(1, static_cast<int>(std::ceil(std::sqrt(static_cast<double>(loadedImages.size())))));
     m_atlasWidth = texturesPerRow * texSize;
+    m_tilesPerRow = texturesPerRow;
     m_atlasHeight = static_cast<int>(std::ceil(static_cast<double>(loadedImages.size()) / texturesPerRow)) * texSize;
     if (m_atlasHeight == 0 && !loadedImages.empty()) { 
         m_atlasHeight = texSize;
@@ -86,7 +87,7 @@ void TextureManager::loadAndStitch() {
     }
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_atlasWidth, m_atlasHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, atlas_initial_data.data());
 
-    std::map<std::string, TextureCoords> uvMap;
+    std::map<std::string, uint16_t> tileMap;
     int currentX = 0;
     int currentY = 0;
 
@@ -105,12 +106,7 @@ void TextureManager::loadAndStitch() {
 
         glTexSubImage2D(GL_TEXTURE_2D, 0, currentX, currentY, img.width, img.height, GL_RGBA, GL_UNSIGNED_BYTE, img.data);
         
-        uvMap[img.name] = {
-            .min = glm::vec2(static_cast<float>(currentX) / m_atlasWidth,
-                             static_cast<float>(currentY) / m_atlasHeight),
-            .max = glm::vec2(static_cast<float>(currentX + img.width) / m_atlasWidth,
-                             static_cast<float>(currentY + img.height) / m_atlasHeight)
-        };
+        tileMap[img.name] = static_cast<uint16_t>((currentY / texSize) * texturesPerRow + currentX / texSize);
         currentX += texSize; 
         stbi_image_free(img.data);
     }
@@ -122,7 +118,9 @@ void TextureManager::loadAndStitch() {
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
     glBindTexture(GL_TEXTURE_2D, 0);
 
-    for(auto const& [type, blockTypeProperties] : Block::blockTypeData) {
+    Block::block_data = {};
+    for(std::size_t typeIndex = 0; typeIndex < BLOCK_TYPE_COUNT; ++typeIndex) {
+        const BlockType type = static_cast<BlockType>(typeIndex);
         auto path_it = m_blockTexturePaths.find(type);
         if(path_it == m_blockTexturePaths.end()) {
             if (type != BlockType::AIR) { }
@@ -130,40 +128,39 @@ void TextureManager::loadAndStitch() {
         }
 
         BlockData data;
-        data.isOpaque = blockTypeProperties.isOpaque; 
+        data.isOpaque = Block::isOpaque(type);
         
         const std::string& side_texture_filename = path_it->second;
-        if (uvMap.count(side_texture_filename)) {
-            data.side_uvs = uvMap.at(side_texture_filename);
+        if (tileMap.count(side_texture_filename)) {
+            data.side_tile = tileMap.at(side_texture_filename);
         } else {
-            std::cerr << "TextureManager Error: Missing UVs for side texture '" << side_texture_filename << "' for BlockType " << static_cast<int>(type) << std::endl;
-            data.side_uvs = {}; 
+            std::cerr << "TextureManager Error: Missing tile for side texture '" << side_texture_filename << "' for BlockType " << static_cast<int>(type) << std::endl;
+            data.side_tile = 0; 
         }
         
-        data.top_uvs = data.side_uvs; 
+        data.top_tile = data.side_tile; 
         auto top_path_it = m_topTexturePaths.find(type);
         if (top_path_it != m_topTexturePaths.end()) {
             const std::string& top_texture_filename = top_path_it->second;
-            if (uvMap.count(top_texture_filename)) {
-                data.top_uvs = uvMap.at(top_texture_filename);
+            if (tileMap.count(top_texture_filename)) {
+                data.top_tile = tileMap.at(top_texture_filename);
             } else {
-                 std::cerr << "TextureManager Error: Missing UVs for top texture '" << top_texture_filename << "' for BlockType " << static_cast<int>(type) << std::endl;
+                 std::cerr << "TextureManager Error: Missing tile for top texture '" << top_texture_filename << "' for BlockType " << static_cast<int>(type) << std::endl;
             }
         }
         
-        data.bottom_uvs = data.side_uvs; 
+        data.bottom_tile = data.side_tile; 
         auto bottom_path_it = m_bottomTexturePaths.find(type);
         if (bottom_path_it != m_bottomTexturePaths.end()) {
             const std::string& bottom_texture_filename = bottom_path_it->second;
-            if(uvMap.count(bottom_texture_filename)) {
-                data.bottom_uvs = uvMap.at(bottom_texture_filename);
+            if(tileMap.count(bottom_texture_filename)) {
+                data.bottom_tile = tileMap.at(bottom_texture_filename);
             } else {
-                std::cerr << "TextureManager Error: Missing UVs for bottom texture '" << bottom_texture_filename << "' for BlockType " << static_cast<int>(type) << std::endl;
+                std::cerr << "TextureManager Error: Missing tile for bottom texture '" << bottom_texture_filename << "' for BlockType " << static_cast<int>(type) << std::endl;
             }
         }
-        Block::block_data_map[type] = data;
+        Block::block_data[typeIndex] = data;
     }
-    Block::block_data_map[BlockType::AIR] = { .isOpaque = false, .side_uvs = {}, .top_uvs = {}, .bottom_uvs = {} };
 }
 
 glm::vec2 TextureManager::getNormalizedTileSize() const {
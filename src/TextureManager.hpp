@@ -12,6 +12,7 @@ private:
     GLuint m_atlasTextureID;
     int m_atlasWidth;
     int m_atlasHeight;
+    int m_tilesPerRow;
 
     // A map to define which texture files belong to which block.
     // This makes it easy to add new blocks and textures.
@@ -43,4 +44,6 @@ public:
     int getAtlasHeight() const { return m_atlasHeight; }
     // Getter for normalized tile size in the atlas
     glm::vec2 getNormalizedTileSize() const;
+    // The number of tiles in one atlas row; tile i sits at column i % tilesPerRow, row i / tilesPerRow.
+    int getTilesPerRow() const { return m_tilesPerRow; }
 };
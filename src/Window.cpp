@@ -6,7 +6,7 @@
 // Constructor
 Window::Window(int width, int height, const char *title)
     : m_window(nullptr), m_width(width), m_height(height), m_title(title),
-      m_lastX(0.0), m_lastY(0.0), m_firstMouse(true), m_wireframeEnabled(false), m_camera(nullptr)
+      m_lastX(0.0), m_lastY(0.0), m_firstMouse(true), m_wireframeEnabled(false), m_binaryMeshingEnabled(false), m_camera(nullptr)
 {
 }
 
@@ -97,6 +97,18 @@ void Window::updateInput(float deltaTime)
     }
 
     key0_pressed_last_frame = key0_is_pressed;
+
+    // Toggle between the greedy and binary mesher
+    static bool keyM_pressed_last_frame = false;
+    bool keyM_is_pressed = glfwGetKey(m_window, GLFW_KEY_M) == GLFW_PRESS;
+
+    if (keyM_is_pressed && !keyM_pressed_last_frame)
+    {
+        m_binaryMeshingEnabled = !m_binaryMeshingEnabled;
+        std::cout << "Meshing mode: " << (m_binaryMeshingEnabled ? "binary" : "greedy") << std::endl;
+    }
+
+    keyM_pressed_last_frame = keyM_is_pressed;
 }
 
 // Initialize GLFW, GLEW, and create a window.
@@ -173,3 +185,8 @@ bool Window::isWireframeEnabled() const
 {
     return m_wireframeEnabled;
 }
+
+bool Window::isBinaryMeshingEnabled() const
+{
+    return m_binaryMeshingEnabled;
+}
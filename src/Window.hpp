@@ -23,6 +23,7 @@ private:
 
     // Input state
     bool m_wireframeEnabled;
+    bool m_binaryMeshingEnabled;
 
     // Pointer to the main camera for input processing
     Camera *m_camera;
@@ -60,4 +61,5 @@ public:
 
     // Getters
     bool isWireframeEnabled() const;
+    bool isBinaryMeshingEnabled() const;
 };
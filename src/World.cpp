@@ -6,18 +6,45 @@
 #include <glm/gtx/norm.hpp>
 #include <thread>
 #include <iostream>
+#include <chrono>
+#include <bit>
 
 // World constructor: Initializes renderers, generators, and starts all worker threads.
 World::World()
 {
     // Initialize the chunk renderer with a large buffer pool size.
     // Each pool can store a significant number of chunk meshes to reduce the frequency of creating new pools.
-    // Vertex Buffer Capacity: 1,572,864 vertices -> ~54 MiB (with a vertex size of 36 bytes)
-    // Index Buffer Capacity:  2,097,152 indices  -> ~4 MiB (with a 16-bit index size)
-    m_chunkRenderer = std::make_unique<ChunkRenderer>(1572864, 2097152);
-    m_terrainGenerator = std::make_unique<TerrainGenerator>(EmbeddedShaders::terrain_gen_comp);
+    // Quad Buffer Capacity: 524,288 quads -> 4 MiB (with a packed quad size of 8 bytes)
+    m_chunkRenderer = std::make_unique<ChunkRenderer>(524288);
+    if (Constants::USE_GPU_CULLING)
+    {
+        try
+        {
+            m_chunkRenderer->enableGpuCulling(EmbeddedShaders::chunk_cull_comp);
+        }
+        catch (const std::runtime_error &e)
+        {
+            std::cerr << "Warning: GPU culling unavailable (" << e.what() << "), culling on the CPU." << std::endl;
+        }
+    }
+    // The CPU generator owns the column heightmap cache, which the GPU generator reads from too.
+    m_cpuTerrainGenerator = std::make_unique<CpuTerrainGenerator>();
+    std::cout << "CPU terrain generator: " << m_cpuTerrainGenerator->getSimdPathName() << std::endl;
+    if (Constants::USE_GPU_TERRAIN_GENERATION)
+    {
+        try
+        {
+            m_gpuTerrainGenerator = std::make_unique<GpuTerrainGenerator>(EmbeddedShaders::terrain_gen_comp, m_cpuTerrainGenerator->getHeightmapCache(),
+                                                                          m_cpuTerrainGenerator->getSeed());
+        }
+        catch (const std::runtime_error &e)
+        {
+            std::cerr << "Warning: GPU terrain generation unavailable (" << e.what() << "), generating on the CPU." << std::endl;
+        }
+    }
     m_textureManager = std::make_unique<TextureManager>();
     m_lastPlayerChunkCoord = {std::numeric_limits<int>::max(), std::numeric_limits<int>::max(), std::numeric_limits<int>::max()};
+    buildLoadOffsets();
     
     // Load textures and populate the static block data map. Must be done after GL context is ready.
     m_textureManager->loadAndStitch();
@@ -42,7 +69,7 @@ World::~World()
     }
     
     // Notify and join meshing worker threads
-    m_meshRequestQueue.notify_all();
+    m_workerQueue.notify_all();
     for (auto &thread : m_workerThreads)
     {
         if (thread.joinable())
@@ -55,7 +82,7 @@ World::~World()
     {
         glDeleteSync(job.fence);
     }
-    for (const auto& job : m_pendingPboReads)
+    for (const auto& job : m_pendingReadbacks)
     {
         glDeleteSync(job.fence);
     }
@@ -64,176 +91,445 @@ World::~World()
 // The main loop for the dedicated world management thread.
 void World::managementLoop() {
     while (!m_isShuttingDown) {
-        glm::ivec3 playerChunkCoord;
-        // Wait for the main thread to send a new player position
-        if (m_managementQueue.wait_and_pop(playerChunkCoord, m_isShuttingDown)) {
-            updateChunkStates(playerChunkCoord);
+        PlayerView view;
+        // Wait for the main thread to send a new player position or view direction
+        if (m_managementQueue.wait_and_pop(view, m_isShuttingDown)) {
+            // Re-score queued requests first, so new ones are ranked against the same view.
+            // Dropped requests lose their BACKLOG entry so they are requested again if they come back into range.
+            const std::vector<glm::ivec3> dropped = m_chunkRequestQueue.setView(view);
+            if (!dropped.empty()) {
+                std::lock_guard<std::mutex> lock(m_worldDataMutex);
+                for (const auto& coord : dropped) {
+                    const ChunkMap::Entry* entry = m_chunks.find(coord);
+                    if (entry && entry->state == ChunkState::BACKLOG) m_chunks.erase(coord);
+                }
+            }
+            updateChunkStates(view.chunkCoord);
         }
     }
 }
 
-// Heavy logic that determines which chunks to load/unload. Runs on the management thread.
-void World::updateChunkStates(const glm::ivec3& playerChunkCoord) {
+// Squared length of an integer chunk offset (glm's length2 only accepts floating-point vectors).
+static int lengthSq(const glm::ivec3& v) {
+    return v.x * v.x + v.y * v.y + v.z * v.z;
+}
+
+// Precomputes the load sphere and, for each of the 26 single-chunk moves, the shells of
+// offsets that enter the load sphere and leave the unload sphere.
+void World::buildLoadOffsets() {
     const int renderDist = m_renderDistance;
-    const long long unloadDistSq = (renderDist + 2) * (renderDist + 2);
+    const int unloadDist = renderDist + Constants::CHUNK_UNLOAD_MARGIN;
+    const int renderDistSq = renderDist * renderDist;
+    const int unloadDistSq = unloadDist * unloadDist;
+
+    std::vector<glm::ivec3> unloadOffsets;
+    for (int y = -unloadDist; y <= unloadDist; ++y) {
+        for (int x = -unloadDist; x <= unloadDist; ++x) {
+            for (int z = -unloadDist; z <= unloadDist; ++z) {
+                const int distSq = x * x + y * y + z * z;
+                if (distSq <= unloadDistSq) unloadOffsets.emplace_back(x, y, z);
+                if (distSq <= renderDistSq) m_loadOffsets.emplace_back(x, y, z);
+            }
+        }
+    }
 
-    // --- Identify chunks to unload ---
-    std::vector<glm::ivec3> coordsToUnload;
-    {
-        std::lock_guard<std::mutex> lock(m_worldDataMutex);
-        for (const auto& [coord, chunk_ptr] : m_chunks) {
-            long long dx = coord.x - playerChunkCoord.x;
-            long long dy = coord.y - playerChunkCoord.y;
-            long long dz = coord.z - playerChunkCoord.z;
-            if (dx * dx + dy * dy + dz * dz > unloadDistSq) {
-                coordsToUnload.push_back(coord);
+    // Nearest offsets first, so every load list below is already in distance order.
+    std::stable_sort(m_loadOffsets.begin(), m_loadOffsets.end(),
+        [](const glm::ivec3& a, const glm::ivec3& b) { return lengthSq(a) < lengthSq(b); });
+
+    for (int dy = -1; dy <= 1; ++dy) {
+        for (int dx = -1; dx <= 1; ++dx) {
+            for (int dz = -1; dz <= 1; ++dz) {
+                const glm::ivec3 move(dx, dy, dz);
+                if (move == glm::ivec3(0)) continue;
+                const int index = moveIndex(move);
+
+                // Relative to the new centre: offsets that were outside the old load sphere.
+                for (const auto& offset : m_loadOffsets) {
+                    if (lengthSq(offset + move) > renderDistSq) m_loadDeltas[index].push_back(offset);
+                }
+                // Relative to the old centre: offsets that are outside the new unload sphere.
+                for (const auto& offset : unloadOffsets) {
+                    if (lengthSq(offset - move) > unloadDistSq) m_unloadDeltas[index].push_back(offset);
+                }
             }
         }
     }
-    for(const auto& coord : coordsToUnload) {
-        m_unloadQueue.push(coord);
+}
+
+// Maps a single-chunk move (each component in [-1, 1]) to an index into the delta tables.
+int World::moveIndex(const glm::ivec3& move) {
+    return (move.y + 1) * 9 + (move.x + 1) * 3 + (move.z + 1);
+}
+
+// Removes a chunk entry, cancelling any in-flight work for it. Its meshes are freed on the
+// main thread. Expects m_worldDataMutex to be held.
+void World::unloadChunkLocked(const glm::ivec3& coord) {
+    ChunkMap::Entry* entry = m_chunks.find(coord);
+    if (!entry) return;
+    if (entry->chunk) {
+        m_unloadQueue.push(std::move(entry->chunk));
     }
-    
-    // --- Identify chunks to load ---
-    std::vector<glm::ivec3> coordsToLoad;
-    const int renderDistSq = renderDist * renderDist;
+    m_chunks.erase(coord);
+}
+
+// Determines which chunks to load/unload. Runs on the management thread.
+// A move to an adjacent chunk only touches the precomputed delta shells; larger jumps rescan everything.
+void World::updateChunkStates(const glm::ivec3& playerChunkCoord) {
+    const glm::ivec3 move = playerChunkCoord - m_managedChunkCoord;
+    const bool isSingleStep = m_hasManagedChunkCoord && std::abs(move.x) <= 1 && std::abs(move.y) <= 1 && std::abs(move.z) <= 1;
+    if (m_hasManagedChunkCoord && move == glm::ivec3(0)) return;
 
-    for (int y = -renderDist; y <= renderDist; ++y) {
-        for (int x = -renderDist; x <= renderDist; ++x) {
-            for (int z = -renderDist; z <= renderDist; ++z) {
-                if (x * x + y * y + z * z > renderDistSq) continue;
-                
-                glm::ivec3 coord = playerChunkCoord + glm::ivec3(x, y, z);
+    const std::vector<glm::ivec3>& loadOffsets = isSingleStep ? m_loadDeltas[moveIndex(move)] : m_loadOffsets;
 
-                std::lock_guard<std::mutex> lock(m_worldDataMutex);
-                auto it = m_chunkStates.find(coord);
+    std::vector<glm::ivec3> coordsToLoad;
+    {
+        std::lock_guard<std::mutex> lock(m_worldDataMutex);
 
-                if (it == m_chunkStates.end() || it->second == ChunkState::UNDEFINED) {
-                    coordsToLoad.push_back(coord);
-                    m_chunkStates[coord] = ChunkState::BACKLOG;
+        // --- Unload chunks that left the unload sphere ---
+        // A ring-buffer store unloads implicitly when a slot is reclaimed, so it needs neither pass.
+        if constexpr (!ChunkStore::IMPLICIT_UNLOAD) {
+            if (isSingleStep) {
+                for (const auto& offset : m_unloadDeltas[moveIndex(move)]) {
+                    unloadChunkLocked(m_managedChunkCoord + offset);
+                }
+            } else {
+                const int unloadDist = m_renderDistance + Constants::CHUNK_UNLOAD_MARGIN;
+                std::vector<glm::ivec3> coordsToUnload;
+                m_chunks.forEach([&](const ChunkMap::Entry& entry) {
+                    const glm::ivec3 coord = entry.coord();
+                    if (lengthSq(coord - playerChunkCoord) > unloadDist * unloadDist) {
+                        coordsToUnload.push_back(coord);
+                    }
+                });
+                for (const auto& coord : coordsToUnload) {
+                    unloadChunkLocked(coord);
                 }
             }
         }
+
+        // --- Request chunks that entered the load sphere ---
+        for (const auto& offset : loadOffsets) {
+            const glm::ivec3 coord = playerChunkCoord + offset;
+            ChunkMap::Entry& entry = m_chunks.findOrInsert(coord);
+            if (entry.state == ChunkState::UNDEFINED) {
+                entry.state = ChunkState::BACKLOG;
+                coordsToLoad.push_back(coord);
+            }
+        }
     }
 
-    if (!coordsToLoad.empty()) {
-        std::sort(coordsToLoad.begin(), coordsToLoad.end(),
-            [&](const glm::ivec3& a, const glm::ivec3& b) {
-                return glm::distance2(glm::vec3(a), glm::vec3(playerChunkCoord)) <
-                    glm::distance2(glm::vec3(b), glm::vec3(playerChunkCoord));
-            });
-            
-        for (const auto& coord : coordsToLoad) {
-            m_gpuRequestQueue.push(coord);
+    m_managedChunkCoord = playerChunkCoord;
+    m_hasManagedChunkCoord = true;
+
+    resolveUniformChunks(coordsToLoad);
+    m_chunkRequestQueue.push(coordsToLoad);
+}
+
+// Creates the requested chunks that the column surface bounds prove to be all AIR or all STONE
+// directly, and removes them from `coordsToLoad`. Only the rest needs a generator. Looking up every
+// column also warms the heightmap cache here, so the main thread finds the heights ready when it
+// dispatches GPU batches.
+void World::resolveUniformChunks(std::vector<glm::ivec3>& coordsToLoad) {
+    HeightmapCache& heightmaps = m_cpuTerrainGenerator->getHeightmapCache();
+
+    std::vector<std::pair<glm::ivec3, std::shared_ptr<Chunk>>> uniformChunks;
+    std::shared_ptr<const ColumnHeightmap> heightmap;
+    glm::ivec2 heightmapColumn{};
+    auto remaining = coordsToLoad.begin();
+    for (const auto& coord : coordsToLoad) {
+        if (!heightmap || heightmapColumn != glm::ivec2(coord.x, coord.z)) {
+            heightmap = heightmaps.get(coord.x, coord.z);
+            heightmapColumn = glm::ivec2(coord.x, coord.z);
+        }
+        if (auto type = TerrainGenerator::uniformBlockType(coord.y, heightmap->minHeight, heightmap->maxHeight)) {
+            uniformChunks.emplace_back(coord, std::make_shared<Chunk>(coord, *type));
+        } else {
+            *remaining++ = coord;
+        }
+    }
+    coordsToLoad.erase(remaining, coordsToLoad.end());
+    if (uniformChunks.empty()) return;
+
+    std::lock_guard<std::mutex> lock(m_worldDataMutex);
+    for (const auto& [coord, chunk] : uniformChunks) {
+        ChunkMap::Entry* entry = m_chunks.find(coord);
+        if (entry && entry->state == ChunkState::BACKLOG) {
+            entry->chunk = chunk;
+            entry->state = ChunkState::DATA_READY;
+            queueMeshingLocked(coord, *chunk);
         }
     }
 }
 
 
-// The main loop for each CPU meshing worker thread.
+// The main loop for each CPU worker thread: builds chunks from generated data and meshes them.
 void World::workerLoop()
 {
     while (!m_isShuttingDown)
     {
-        glm::ivec3 coord;
-        if (m_meshRequestQueue.wait_and_pop(coord, m_isShuttingDown))
+        WorkerTask task;
+        if (!m_workerQueue.wait_and_pop(task, m_isShuttingDown))
+            continue;
+
+        if (task.type == WorkerTask::Type::BUILD_CHUNK)
         {
-            std::shared_ptr<Chunk> chunkToMesh;
-            {
-                std::lock_guard<std::mutex> lock(m_worldDataMutex);
-                auto it = m_chunks.find(coord);
-                if (it != m_chunks.end())
-                {
-                    chunkToMesh = it->second;
-                }
-            }
-            if (chunkToMesh)
-            {
-                // Generate the mesh for the chunk (a computationally expensive operation) and push the result.
-                m_meshResultQueue.push(chunkToMesh->generateMeshStandalone(*this));
-            }
+            buildChunk(task);
+            continue;
+        }
+        if (task.type == WorkerTask::Type::GENERATE_CHUNK)
+        {
+            generateChunkOnWorker(task.chunkCoord);
+            m_cpuGenerationsInFlight--;
+            continue;
+        }
+
+        ChunkSnapshot snapshot;
+        std::shared_ptr<Chunk> chunkToMesh = buildSnapshot(task.chunkCoord, snapshot);
+        if (chunkToMesh)
+        {
+            // Generate the mesh for the chunk (a computationally expensive operation) and push the result.
+            const auto start = std::chrono::steady_clock::now();
+            MeshResult result = chunkToMesh->generateMeshStandalone(snapshot, m_meshingMode.load());
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+
+            m_meshingTimeNs += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+            m_meshedChunkCount++;
+            m_meshResultQueue.push(std::move(result));
         }
     }
 }
 
+// Creates a Chunk from its generated blocks in the readback ring and queues it for meshing. Runs on a worker thread.
+void World::buildChunk(WorkerTask &task)
+{
+    // Skip chunks cancelled since the read-back finished.
+    if (!isChunkInState(task.chunkCoord, ChunkState::READBACK_PENDING))
+        return;
+
+    // Uniform chunks (flagged by the compute shader) skip the voxel array entirely.
+    const ChunkReadback readback = m_gpuTerrainGenerator->readChunk(task.readback->getSlot(), task.batchIndex);
+    std::shared_ptr<Chunk> chunk;
+    if (!readback.blocks)
+        chunk = std::make_shared<Chunk>(task.chunkCoord, static_cast<BlockType>(std::countr_zero(readback.presentTypes)));
+    else
+        chunk = std::make_shared<Chunk>(task.chunkCoord, readback.blocks, readback.presentTypes);
+
+    // The chunk owns a copy now; let the ring slot go as early as possible.
+    task.readback.reset();
+    insertGeneratedChunk(task.chunkCoord, chunk, ChunkState::READBACK_PENDING);
+}
+
+// Generates a chunk with the CPU terrain generator and queues it for meshing. Runs on a worker thread.
+void World::generateChunkOnWorker(const glm::ivec3 &coord)
+{
+    // Skip chunks cancelled while queued.
+    if (!isChunkInState(coord, ChunkState::GENERATING))
+        return;
+
+    BlockType blocks[Constants::CHUNK_VOL];
+    const uint32_t presentTypes = m_cpuTerrainGenerator->generateChunk(coord, blocks);
+    std::shared_ptr<Chunk> chunk;
+    if (std::has_single_bit(presentTypes))
+        chunk = std::make_shared<Chunk>(coord, static_cast<BlockType>(std::countr_zero(presentTypes)));
+    else
+        chunk = std::make_shared<Chunk>(coord, blocks, presentTypes);
+
+    insertGeneratedChunk(coord, chunk, ChunkState::GENERATING);
+}
+
+// Stores a freshly generated chunk and queues it for meshing, unless it left `expectedState` meanwhile.
+void World::insertGeneratedChunk(const glm::ivec3 &coord, const std::shared_ptr<Chunk> &chunk, ChunkState expectedState)
+{
+    // Results for chunks unloaded in the meantime are dropped rather than re-inserted,
+    // which in a ring buffer would evict whatever has claimed the slot since.
+    std::lock_guard<std::mutex> lock(m_worldDataMutex);
+    ChunkMap::Entry *entry = m_chunks.find(coord);
+    if (entry && entry->state == expectedState)
+    {
+        entry->chunk = chunk;
+        entry->state = ChunkState::DATA_READY;
+        queueMeshingLocked(coord, *chunk);
+    }
+}
+
 // Main world update function, called every frame on the main thread.
-void World::update(const glm::vec3 &playerPos)
+void World::update(const Camera &camera)
 {
+    const glm::vec3 &playerPos = camera.getPosition();
+    const glm::vec3 &viewDirection = camera.getFront();
+
     glm::ivec3 playerChunkCoord = {
         static_cast<int>(std::floor(playerPos.x / Constants::CHUNK_WIDTH)),
         static_cast<int>(std::floor(playerPos.y / Constants::CHUNK_WIDTH)),
         static_cast<int>(std::floor(playerPos.z / Constants::CHUNK_WIDTH))};
 
-    // --- Trigger world management if player has moved ---
-    if (playerChunkCoord != m_lastPlayerChunkCoord)
+    // --- Trigger world management if player has moved or turned far enough to reorder loading ---
+    if (playerChunkCoord != m_lastPlayerChunkCoord || glm::dot(viewDirection, m_lastViewDirection) < VIEW_RESCORE_COS)
     {
         m_lastPlayerChunkCoord = playerChunkCoord;
-        m_managementQueue.push(playerChunkCoord);
+        m_lastViewDirection = viewDirection;
+        m_managementQueue.push(PlayerView{playerChunkCoord, viewDirection, camera});
     }
 
     // --- Process all asynchronous pipeline stages on the main thread ---
     processUnloads();
-    processPboReads();
+    processReadbacks();
     processCompletedGpuJobs();
-    dispatchGpuJobs();
+    dispatchGenerationJobs();
 
     // --- Finalize meshes that have been completed by worker threads ---
     MeshResult result;
     while (m_meshResultQueue.try_pop(result))
     {
         std::lock_guard<std::mutex> lock(m_worldDataMutex);
-        auto it = m_chunks.find(result.chunkCoord);
-        if (it != m_chunks.end())
+        // Results for chunks that were unloaded (or reloaded) while meshing are discarded.
+        ChunkMap::Entry *entry = m_chunks.find(result.chunkCoord);
+        if (entry && entry->chunk && entry->state == ChunkState::MESH_PENDING)
         {
-            m_chunkRenderer->freeMesh(it->second->getOpaqueMeshAllocation());
-            m_chunkRenderer->freeMesh(it->second->getTransparentMeshAllocation());
+            m_chunkRenderer->freeMesh(entry->chunk->getOpaqueMeshAllocation());
+            m_chunkRenderer->freeMesh(entry->chunk->getTransparentMeshAllocation());
+
+            MeshAllocation opaqueAllocation = m_chunkRenderer->allocateMesh(result.opaqueQuads);
+            const AABB &bounds = entry->chunk->getExpandedAABB();
+            m_chunkRenderer->addCulledMesh(opaqueAllocation, bounds.min, bounds.max, entry->chunk->getPosition());
+            entry->chunk->setOpaqueMeshAllocation(opaqueAllocation);
+            entry->chunk->setTransparentMeshAllocation(m_chunkRenderer->allocateMesh(result.transparentQuads));
+
+            // The region tree is only read when occlusion culling is off (see render).
+            if constexpr (!Constants::USE_OCCLUSION_CULLING)
+            {
+                const bool needsCpuCulling = entry->chunk->getTransparentMeshAllocation().isValid() ||
+                                             (opaqueAllocation.isValid() && !m_chunkRenderer->isGpuCullingEnabled());
+                if (needsCpuCulling)
+                    m_cpuCulledChunks.insert(entry->chunk);
+                else
+                    m_cpuCulledChunks.remove(entry->chunk);
+            }
 
-            it->second->setOpaqueMeshAllocation(m_chunkRenderer->allocateMesh(result.opaqueVertices, result.opaqueIndices));
-            it->second->setTransparentMeshAllocation(m_chunkRenderer->allocateMesh(result.transparentVertices, result.transparentIndices));
-            
-            m_chunkStates[result.chunkCoord] = ChunkState::READY;
+            entry->state = ChunkState::READY;
         }
     }
 }
 
 // Processes the unload queue on the main thread (needs OpenGL context).
 void World::processUnloads() {
-    glm::ivec3 coord;
-    while(m_unloadQueue.try_pop(coord)) {
+    {
+        // Chunks whose ring-buffer slots were reclaimed by the management thread.
         std::lock_guard<std::mutex> lock(m_worldDataMutex);
-        auto it = m_chunks.find(coord);
-        if (it != m_chunks.end()) {
-            m_chunkRenderer->freeMesh(it->second->getOpaqueMeshAllocation());
-            m_chunkRenderer->freeMesh(it->second->getTransparentMeshAllocation());
-            m_chunks.erase(it);
+        for (const auto& chunk : m_chunks.takeEvicted()) {
+            m_chunkRenderer->freeMesh(chunk->getOpaqueMeshAllocation());
+            m_chunkRenderer->freeMesh(chunk->getTransparentMeshAllocation());
+            if constexpr (!Constants::USE_OCCLUSION_CULLING)
+                m_cpuCulledChunks.remove(chunk);
         }
-        m_chunkStates[coord] = ChunkState::UNDEFINED;
+    }
+
+    // Chunks the management thread has already removed from the world.
+    std::shared_ptr<Chunk> chunk;
+    while(m_unloadQueue.try_pop(chunk)) {
+        m_chunkRenderer->freeMesh(chunk->getOpaqueMeshAllocation());
+        m_chunkRenderer->freeMesh(chunk->getTransparentMeshAllocation());
+        if constexpr (!Constants::USE_OCCLUSION_CULLING)
+            m_cpuCulledChunks.remove(chunk);
     }
 }
 
 
-// Tries to send jobs from the request queue to the GPU.
-void World::dispatchGpuJobs()
+// Sends the next batch of requests to the GPU, and hands requests to the worker threads when
+// there is no GPU generator or all of its batch slots are busy.
+void World::dispatchGenerationJobs()
 {
-    glm::ivec3 coord;
-    // Check if there are slots and if there's anything in the queue
-    if (m_terrainGenerator->hasAvailableJobSlots() && m_gpuRequestQueue.try_pop(coord))
+    std::vector<glm::ivec3> popped;
+    if (m_gpuTerrainGenerator && m_gpuTerrainGenerator->hasAvailableJobSlots())
     {
-        auto job = m_terrainGenerator->dispatchJob(coord);
+        // Gather the highest-priority requests, skipping those cancelled while queued.
+        HeightmapCache &heightmaps = m_cpuTerrainGenerator->getHeightmapCache();
+        const size_t batchSize = static_cast<size_t>(m_gpuTerrainGenerator->getBatchSize());
+        std::vector<glm::ivec3> batch;
+        std::vector<std::shared_ptr<const ColumnHeightmap>> batchHeightmaps;
+        std::vector<glm::ivec3> evictedColumns;
+        batch.reserve(batchSize);
+        batchHeightmaps.reserve(batchSize);
+        while (batch.size() < batchSize && m_chunkRequestQueue.tryPop(popped, batchSize - batch.size()))
+        {
+            claimRequests(popped);
+            for (const auto &coord : popped)
+            {
+                // The management thread warmed the column before queueing the request. Should it have been
+                // evicted since, a worker generates the chunk instead of computing the heights on this thread.
+                auto heightmap = heightmaps.find(coord.x, coord.z);
+                if (!heightmap)
+                {
+                    evictedColumns.push_back(coord);
+                    continue;
+                }
+                batch.push_back(coord);
+                batchHeightmaps.push_back(std::move(heightmap));
+            }
+        }
+        queueCpuGenerations(evictedColumns);
+        if (batch.empty())
+            return;
+
+        auto job = m_gpuTerrainGenerator->dispatchJob(batch, batchHeightmaps);
         if (job)
         {
-            m_pendingGpuJobs.push_back(*job);
-            std::lock_guard<std::mutex> lock(m_worldDataMutex);
-            m_chunkStates[coord] = ChunkState::GPU_PENDING;
-        } else {
-             // If dispatchJob fails unexpectedly (e.g., in a multi-threaded context where another
-             // thread took the last slot), the request is effectively dropped for this frame.
-             // The management thread will re-queue it on a subsequent update if it is still needed.
+            m_pendingGpuJobs.push_back(std::move(*job));
+        }
+        else
+        {
+            // If dispatchJob fails unexpectedly, the requests go back to the queue for a later frame.
+            {
+                std::lock_guard<std::mutex> lock(m_worldDataMutex);
+                for (const auto &coord : batch)
+                {
+                    ChunkMap::Entry *entry = m_chunks.find(coord);
+                    if (entry && entry->state == ChunkState::GENERATING)
+                        entry->state = ChunkState::BACKLOG;
+                }
+            }
+            m_chunkRequestQueue.push(batch);
         }
+        return;
+    }
+
+    // Keep a couple of generation tasks per worker queued, so meshing is never starved for long.
+    const int maxInFlight = 2 * static_cast<int>(m_workerThreads.size());
+    while (m_cpuGenerationsInFlight < maxInFlight &&
+           m_chunkRequestQueue.tryPop(popped, static_cast<size_t>(maxInFlight - m_cpuGenerationsInFlight)))
+    {
+        claimRequests(popped);
+        queueCpuGenerations(popped);
+    }
+}
+
+// Moves popped requests from BACKLOG to GENERATING under a single lock, and drops those cancelled
+// while queued (the chunk was unloaded or its slot reclaimed).
+void World::claimRequests(std::vector<glm::ivec3> &coords)
+{
+    std::lock_guard<std::mutex> lock(m_worldDataMutex);
+    std::erase_if(coords, [this](const glm::ivec3 &coord)
+    {
+        ChunkMap::Entry *entry = m_chunks.find(coord);
+        if (!entry || entry->state != ChunkState::BACKLOG)
+            return true;
+        entry->state = ChunkState::GENERATING;
+        return false;
+    });
+}
+
+// Hands claimed requests to the worker threads' CPU generator.
+void World::queueCpuGenerations(const std::vector<glm::ivec3> &coords)
+{
+    for (const auto &coord : coords)
+    {
+        m_cpuGenerationsInFlight++;
+        m_workerQueue.push(WorkerTask{WorkerTask::Type::GENERATE_CHUNK, coord, nullptr, 0});
     }
 }
 
-// Checks for finished GPU jobs and schedules them for async read-back via PBOs.
+// Checks for finished GPU batches and schedules them for async read-back into the readback ring.
 void World::processCompletedGpuJobs()
 {
     for (auto it = m_pendingGpuJobs.begin(); it != m_pendingGpuJobs.end();)
@@ -241,18 +537,34 @@ void World::processCompletedGpuJobs()
         GLenum waitResult = glClientWaitSync(it->fence, 0, 0);
         if (waitResult == GL_ALREADY_SIGNALED || waitResult == GL_CONDITION_SATISFIED)
         {
-            auto pboJob = m_terrainGenerator->scheduleRead(*it);
+            // Cancelled while generating: if no chunk of the batch is still wanted,
+            // release it without copying its results.
+            const bool anyWanted = std::ranges::any_of(it->chunkCoords, [this](const glm::ivec3 &c)
+                                                       { return isChunkInState(c, ChunkState::GENERATING); });
+            if (!anyWanted)
+            {
+                m_gpuTerrainGenerator->releaseGpuJob(*it);
+                it = m_pendingGpuJobs.erase(it);
+                continue;
+            }
 
-            if (pboJob) {
-                m_pendingPboReads.push_back(*pboJob);
+            auto readbackJob = m_gpuTerrainGenerator->scheduleRead(*it);
+
+            if (readbackJob) {
                 {
                     std::lock_guard<std::mutex> lock(m_worldDataMutex);
-                    m_chunkStates[it->chunkCoord] = ChunkState::PBO_PENDING;
+                    for (const auto &coord : readbackJob->chunkCoords)
+                    {
+                        ChunkMap::Entry *entry = m_chunks.find(coord);
+                        if (entry && entry->state == ChunkState::GENERATING)
+                            entry->state = ChunkState::READBACK_PENDING;
+                    }
                 }
-                m_terrainGenerator->releaseGpuJob(*it);
+                m_pendingReadbacks.push_back(std::move(*readbackJob));
+                m_gpuTerrainGenerator->releaseGpuJob(*it);
                 it = m_pendingGpuJobs.erase(it);
             } else {
-                // PBO pool was full, try again next frame.
+                // Every readback slot is still in use, try again next frame.
                 ++it;
             }
         }
@@ -263,31 +575,27 @@ void World::processCompletedGpuJobs()
     }
 }
 
-// Checks for finished PBO-to-RAM transfers, creates Chunk objects, and queues them for meshing.
-void World::processPboReads()
+// Polls the read-back fences and hands finished chunks to the worker threads, which read them
+// straight from the mapped readback ring.
+void World::processReadbacks()
 {
-    for (auto it = m_pendingPboReads.begin(); it != m_pendingPboReads.end();)
+    for (auto it = m_pendingReadbacks.begin(); it != m_pendingReadbacks.end();)
     {
         GLenum waitResult = glClientWaitSync(it->fence, 0, 0);
         if (waitResult == GL_ALREADY_SIGNALED || waitResult == GL_CONDITION_SATISFIED)
         {
-            uint32_t blockData[Constants::CHUNK_VOL];
-            m_terrainGenerator->readPboData(*it, blockData);
+            glDeleteSync(it->fence);
 
+            // The lease returns the slot once the last worker is done with it. Chunks cancelled during
+            // the read-back are not handed out; if none is left, the slot is released right here.
+            auto lease = std::make_shared<ReadbackLease>(*m_gpuTerrainGenerator, it->slot);
+            for (size_t i = 0; i < it->chunkCoords.size(); ++i)
             {
-                std::lock_guard<std::mutex> lock(m_worldDataMutex);
-                m_chunks[it->chunkCoord] = std::make_shared<Chunk>(it->chunkCoord, blockData);
-                m_chunkStates[it->chunkCoord] = ChunkState::DATA_READY;
+                if (isChunkInState(it->chunkCoords[i], ChunkState::READBACK_PENDING))
+                    m_workerQueue.push(WorkerTask{WorkerTask::Type::BUILD_CHUNK, it->chunkCoords[i], lease, i});
             }
-            
-            m_meshRequestQueue.push(it->chunkCoord);
-             {
-                std::lock_guard<std::mutex> lock(m_worldDataMutex);
-                m_chunkStates[it->chunkCoord] = ChunkState::MESH_PENDING;
-            }
-            
-            m_terrainGenerator->releasePboJob(*it);
-            it = m_pendingPboReads.erase(it);
+
+            it = m_pendingReadbacks.erase(it);
         }
         else
         {
@@ -296,6 +604,68 @@ void World::processPboReads()
     }
 }
 
+// Returns true if the chunk at `coord` is still tracked and in the given pipeline state. A job whose
+// chunk has moved on (most often because it was unloaded, which cancels it) should be dropped.
+bool World::isChunkInState(const glm::ivec3 &coord, ChunkState state) const
+{
+    std::lock_guard<std::mutex> lock(m_worldDataMutex);
+    const ChunkMap::Entry *entry = m_chunks.find(coord);
+    return entry && entry->state == state;
+}
+
+// Returns true if a chunk can have no visible faces of its own until a neighbour exposes one:
+// it is uniform and made of an opaque block type.
+static bool isUniformOpaque(const Chunk &chunk)
+{
+    return chunk.isUniform() && Block::isOpaque(chunk.getBlock(0, 0, 0));
+}
+
+// Decides whether a freshly loaded chunk needs a meshing job, and queues any uniform opaque
+// neighbours that were skipped earlier but now have an exposed face. Expects m_worldDataMutex to be held.
+void World::queueMeshingLocked(const glm::ivec3 &coord, const Chunk &chunk)
+{
+    // Non-uniform chunks are always meshed. All-AIR chunks never have faces, and uniform
+    // opaque chunks only where a neighbour exposes them (checked below).
+    const BlockType uniformType = chunk.getBlock(0, 0, 0);
+    bool needsMesh = !chunk.isUniform() || (uniformType != BlockType::AIR && !Block::isOpaque(uniformType));
+
+    for (int face = 0; face < 6; ++face)
+    {
+        const int axis = face / 2;
+        const int side = (face % 2 == 0) ? -1 : 1;
+        glm::ivec3 neighbourCoord = coord;
+        neighbourCoord[axis] += side;
+
+        ChunkMap::Entry *neighbourEntry = m_chunks.find(neighbourCoord);
+        if (!neighbourEntry || !neighbourEntry->chunk)
+            continue;
+        const Chunk &neighbour = *neighbourEntry->chunk;
+
+        // A uniform opaque chunk only gets faces where a loaded neighbour shows a non-opaque block.
+        if (isUniformOpaque(chunk) && neighbour.hasNonOpaqueBoundary(axis, -side))
+            needsMesh = true;
+
+        // Conversely, wake up a skipped uniform opaque neighbour that this chunk exposes.
+        if (isUniformOpaque(neighbour) && !neighbour.getOpaqueMeshAllocation().isValid() &&
+            neighbourEntry->state == ChunkState::READY && chunk.hasNonOpaqueBoundary(axis, side))
+        {
+            neighbourEntry->state = ChunkState::MESH_PENDING;
+            m_workerQueue.push(WorkerTask{WorkerTask::Type::MESH, neighbourCoord, nullptr, 0});
+        }
+    }
+
+    ChunkMap::Entry &entry = m_chunks.findOrInsert(coord);
+    if (needsMesh)
+    {
+        entry.state = ChunkState::MESH_PENDING;
+        m_workerQueue.push(WorkerTask{WorkerTask::Type::MESH, coord, nullptr, 0});
+    }
+    else
+    {
+        entry.state = ChunkState::READY;
+    }
+}
+
 // Gets the block type at a given world position (thread-safe).
 BlockType World::getBlock(const glm::ivec3 &worldBlockPos) const
 {
@@ -308,18 +678,174 @@ BlockType World::getBlock(const glm::ivec3 &worldBlockPos) const
     std::shared_ptr<Chunk> chunk;
     {
         std::lock_guard<std::mutex> lock(m_worldDataMutex);
-        auto it = m_chunks.find(chunkCoord);
-        if (it == m_chunks.end())
+        chunk = m_chunks.findChunk(chunkCoord);
+        if (!chunk)
         {
             return BlockType::AIR;
         }
-        chunk = it->second;
     }
 
     glm::ivec3 localPos = worldBlockPos - (chunkCoord * Constants::CHUNK_DIM);
     return chunk->getBlock(localPos.x, localPos.y, localPos.z);
 }
 
+// Builds the padded block snapshot for a chunk, taking the world lock only once.
+std::shared_ptr<Chunk> World::buildSnapshot(const glm::ivec3 &chunkCoord, ChunkSnapshot &out) const
+{
+    std::shared_ptr<Chunk> chunk;
+    std::shared_ptr<Chunk> neighbours[6];
+    {
+        std::lock_guard<std::mutex> lock(m_worldDataMutex);
+        chunk = m_chunks.findChunk(chunkCoord);
+        if (!chunk)
+        {
+            return nullptr;
+        }
+
+        for (int face = 0; face < 6; ++face)
+        {
+            glm::ivec3 neighbourCoord = chunkCoord;
+            neighbourCoord[face / 2] += (face % 2 == 0) ? -1 : 1;
+            neighbours[face] = m_chunks.findChunk(neighbourCoord);
+        }
+    }
+
+    // Chunk block data never changes after construction, so the copy can happen outside the lock.
+    std::fill(&out.blocks[0][0][0], &out.blocks[0][0][0] + sizeof(out.blocks) / sizeof(BlockType), BlockType::AIR);
+    chunk->copyToSnapshot(out);
+    for (int face = 0; face < 6; ++face)
+    {
+        if (neighbours[face])
+        {
+            neighbours[face]->copyFaceToSnapshot(out, face / 2, (face % 2 == 0) ? -1 : 1);
+        }
+    }
+    return chunk;
+}
+
+// Walks outward from the camera's chunk, breadth first, and collects the meshed chunks it reaches. A
+// chunk is only left through a face that its non-opaque blocks connect to the face it was entered by,
+// never back towards the camera (against a direction already travelled), and only into chunks in the
+// frustum and within the retain distance. Chunks that are not loaded are treated as open.
+void World::collectReachableChunks(const Camera &camera, std::vector<std::shared_ptr<Chunk>> &out)
+{
+    // ReachCell::flags: the faces a chunk has been entered by (bits 0-5), whether it is outside the
+    // frustum, and whether its connectivity has been looked up.
+    constexpr uint8_t ENTERED_FACES = 0x3F;
+    constexpr uint8_t OUTSIDE_FRUSTUM = 1u << 6;
+    constexpr uint8_t LOOKED_UP = 1u << 7;
+
+    const int reach = m_renderDistance + Constants::CHUNK_UNLOAD_MARGIN;
+    const int gridDim = 2 * reach + 1;
+    const size_t gridSize = static_cast<size_t>(gridDim) * gridDim * gridDim;
+    // The grid is only cleared when it is (re)allocated or the epoch wraps; every walk starts a new epoch.
+    if (m_reachGrid.size() != gridSize || ++m_reachEpoch == 0)
+    {
+        m_reachGrid.assign(gridSize, ReachCell{});
+        m_reachEpoch = 1;
+    }
+
+    const glm::ivec3 cameraChunk(glm::floor(camera.getPosition() / Constants::CHUNK_WIDTH));
+    auto cellAt = [&](const glm::ivec3 &offset) -> ReachCell &
+    {
+        ReachCell &cell = m_reachGrid[(static_cast<size_t>(offset.x + reach) * gridDim + (offset.y + reach)) * gridDim + (offset.z + reach)];
+        if (cell.epoch != m_reachEpoch)
+            cell = ReachCell{m_reachEpoch, 0, 0};
+        return cell;
+    };
+
+    // A chunk to leave, entered by entryFace (-1 for the camera's chunk), having travelled along travelledFaces.
+    struct Step
+    {
+        glm::ivec3 coord;
+        int entryFace;
+        uint8_t travelledFaces;
+    };
+    std::vector<Step> layer{{cameraChunk, -1, 0}};
+    std::vector<Step> nextLayer;
+    cellAt(glm::ivec3(0)).flags = ENTERED_FACES; // Never re-entered
+
+    // The chunks entered for the first time from the current layer, frustum-tested together.
+    std::array<std::vector<float>, 6> bounds; // minX, minY, minZ, maxX, maxY, maxZ
+    std::vector<ReachCell *> testedCells;
+    std::vector<uint64_t> visibleMask;
+
+    while (!layer.empty())
+    {
+        nextLayer.clear();
+        testedCells.clear();
+        for (auto &axisBounds : bounds)
+            axisBounds.clear();
+
+        for (const Step &step : layer)
+        {
+            ReachCell &cell = cellAt(step.coord - cameraChunk);
+            // A chunk entered by several faces is walked from each, but looked up once.
+            if (!(cell.flags & LOOKED_UP))
+            {
+                cell.flags |= LOOKED_UP;
+                std::shared_ptr<Chunk> chunk;
+                {
+                    std::lock_guard<std::mutex> lock(m_worldDataMutex);
+                    chunk = m_chunks.findChunk(step.coord);
+                }
+                // Block data and mesh allocations (only changed on this thread) need no lock.
+                cell.connectivity = chunk ? chunk->getFaceConnectivity() : Chunk::ALL_FACES_CONNECTED;
+                if (chunk && (chunk->getOpaqueMeshAllocation().isValid() || chunk->getTransparentMeshAllocation().isValid()))
+                    out.push_back(std::move(chunk));
+            }
+
+            for (int face = 0; face < 6; ++face)
+            {
+                const int oppositeFace = face ^ 1;
+                if ((step.travelledFaces >> oppositeFace) & 1u)
+                    continue;
+                if (step.entryFace >= 0 && !((cell.connectivity >> Chunk::facePairBit(step.entryFace, face)) & 1u))
+                    continue;
+
+                glm::ivec3 next = step.coord;
+                next[face / 2] += (face % 2 == 0) ? -1 : 1;
+                const glm::ivec3 offset = next - cameraChunk;
+                if (lengthSq(offset) > reach * reach)
+                    continue;
+
+                // The neighbour is entered by its face opposite the one this chunk is left by.
+                ReachCell &neighbour = cellAt(offset);
+                if (neighbour.flags & (OUTSIDE_FRUSTUM | (1u << oppositeFace)))
+                    continue;
+                if ((neighbour.flags & ENTERED_FACES) == 0)
+                {
+                    const glm::vec3 boundsMin = glm::vec3(next) * Constants::CHUNK_WIDTH;
+                    for (int axis = 0; axis < 3; ++axis)
+                    {
+                        bounds[axis].push_back(boundsMin[axis]);
+                        bounds[axis + 3].push_back(boundsMin[axis] + Constants::CHUNK_WIDTH);
+                    }
+                    testedCells.push_back(&neighbour);
+                }
+                neighbour.flags |= static_cast<uint8_t>(1u << oppositeFace);
+                nextLayer.push_back({next, oppositeFace, static_cast<uint8_t>(step.travelledFaces | (1u << face))});
+            }
+        }
+
+        // One batched (SIMD) frustum test for the whole layer, then the steps into chunks outside it are dropped.
+        if (!testedCells.empty())
+        {
+            visibleMask.resize((testedCells.size() + 63) / 64);
+            camera.areAABBsVisible({bounds[0].data(), bounds[1].data(), bounds[2].data(), bounds[3].data(), bounds[4].data(), bounds[5].data()},
+                                   testedCells.size(), visibleMask.data());
+            for (size_t i = 0; i < testedCells.size(); ++i)
+            {
+                if (!((visibleMask[i / 64] >> (i % 64)) & 1u))
+                    testedCells[i]->flags |= OUTSIDE_FRUSTUM;
+            }
+            std::erase_if(nextLayer, [&](const Step &step)
+                          { return cellAt(step.coord - cameraChunk).flags & OUTSIDE_FRUSTUM; });
+        }
+        std::swap(layer, nextLayer);
+    }
+}
+
 // Renders all visible chunks.
 void World::render(Shader &shader, const Camera &camera)
 {
@@ -329,46 +855,68 @@ void World::render(Shader &shader, const Camera &camera)
     // Tell the shader that our "u_textureAtlas" uniform should use texture unit 0
     shader.setInt("u_textureAtlas", 0);
 
+    // Chunks that drifted out of range may linger in a ring buffer until their slot is reclaimed.
+    const int retainDist = m_renderDistance + Constants::CHUNK_UNLOAD_MARGIN;
+    const glm::ivec3 playerChunkCoord = m_lastPlayerChunkCoord;
+
+    // With GPU culling the opaque meshes need no CPU work, so the region tree only holds chunks with transparent meshes.
+    const bool gpuCulling = m_chunkRenderer->isGpuCullingEnabled();
+
     std::vector<std::shared_ptr<Chunk>> chunksToRender;
+    if constexpr (Constants::USE_OCCLUSION_CULLING)
     {
-        std::lock_guard<std::mutex> lock(m_worldDataMutex);
-        chunksToRender.reserve(m_chunks.size());
-        for (auto const &[coord, chunk] : m_chunks)
+        // Only the chunks the camera can see into. Their opaque meshes are handed to the GPU culling as a
+        // mask over cull slots; the rest are drawn from the same list as the transparent meshes.
+        collectReachableChunks(camera, chunksToRender);
+        if (gpuCulling)
         {
-            // Frustum cull here before adding to render list
-            if (camera.isAABBVisible(chunk->getExpandedAABB().min, chunk->getExpandedAABB().max))
+            m_visibleCullSlots.assign(m_chunkRenderer->visibleSlotWordCount(), 0);
+            for (const auto &chunk : chunksToRender)
             {
-                chunksToRender.push_back(chunk);
+                const uint32_t slot = chunk->getOpaqueMeshAllocation().cullSlot;
+                if (slot != MeshAllocation::NO_CULL_SLOT)
+                    m_visibleCullSlots[slot / 32] |= 1u << (slot % 32);
             }
+            std::erase_if(chunksToRender, [](const std::shared_ptr<Chunk> &chunk)
+                          { return !chunk->getTransparentMeshAllocation().isValid(); });
+        }
+    }
+    else
+    {
+        // The tree rejects (or accepts) whole regions at once, so this scales with the visible chunks rather than the loaded ones.
+        // Mesh allocations are only changed on this thread, so no lock is needed.
+        m_cpuCulledChunks.collectVisible(camera, chunksToRender);
+        if constexpr (ChunkStore::IMPLICIT_UNLOAD)
+        {
+            std::erase_if(chunksToRender, [&](const std::shared_ptr<Chunk> &chunk)
+                          { return lengthSq(chunk->getChunkCoord() - playerChunkCoord) > retainDist * retainDist; });
         }
     }
-
-    if (chunksToRender.empty())
-        return;
 
     // --- Opaque Pass ---
     glDisable(GL_BLEND);                          // Opaque objects don't need blending
     glDepthMask(GL_TRUE);                         // Ensure depth writing is on
     shader.setBool("u_isTransparentPass", false); // Inform shader this is the opaque pass
 
-    // Sort chunks by pool index to minimize VAO binds.
-    std::sort(chunksToRender.begin(), chunksToRender.end(),
-              [](const std::shared_ptr<Chunk> &a, const std::shared_ptr<Chunk> &b)
-              {
-                  return a->getOpaqueMeshAllocation().poolIndex < b->getOpaqueMeshAllocation().poolIndex;
-              });
-
-    for (const auto &chunk : chunksToRender)
+    if (gpuCulling)
+    {
+        // Culled and drawn entirely on the GPU. Chunks lingering in a ring buffer beyond the retain distance
+        // stay registered until their slot is reclaimed, so they may be drawn for a little longer.
+        m_chunkRenderer->drawCulled(camera.getFrustumPlanes(), Constants::USE_OCCLUSION_CULLING ? &m_visibleCullSlots : nullptr);
+    }
+    else
     {
-        const auto &alloc = chunk->getOpaqueMeshAllocation();
-        if (alloc.isValid())
+        // The renderer groups the draws by pool, so the opaque pass needs no sorting.
+        for (const auto &chunk : chunksToRender)
         {
-            glm::mat4 ModelMatrix = glm::translate(glm::mat4(1.0f), chunk->getPosition());
-            shader.setMat4("ModelMatrix", ModelMatrix);
-            m_chunkRenderer->draw(alloc);
+            m_chunkRenderer->queueDraw(chunk->getOpaqueMeshAllocation(), chunk->getPosition());
         }
+        m_chunkRenderer->submitDraws();
     }
 
+    if (chunksToRender.empty())
+        return;
+
     // --- Transparent Pass ---
     glEnable(GL_BLEND); 
     glDepthMask(GL_FALSE);                       
@@ -393,19 +941,12 @@ void World::render(Shader &shader, const Camera &camera)
                       return glm::distance2(a->getCenterPosition(), cameraPos) > glm::distance2(b->getCenterPosition(), cameraPos);
                   });
 
-        std::stable_sort(transparentChunks.begin(), transparentChunks.end(),
-                         [](const Chunk *a, const Chunk *b)
-                         {
-                             return a->getTransparentMeshAllocation().poolIndex < b->getTransparentMeshAllocation().poolIndex;
-                         });
-
+        // Back to front within each pool; the renderer draws the pools one after another.
         for (const auto *chunk : transparentChunks)
         {
-            const auto &alloc = chunk->getTransparentMeshAllocation();
-            glm::mat4 ModelMatrix = glm::translate(glm::mat4(1.0f), chunk->getPosition());
-            shader.setMat4("ModelMatrix", ModelMatrix);
-            m_chunkRenderer->draw(alloc);
+            m_chunkRenderer->queueDraw(chunk->getTransparentMeshAllocation(), chunk->getPosition());
         }
+        m_chunkRenderer->submitDraws();
     }
 
     glDepthMask(GL_TRUE); 
@@ -418,3 +959,18 @@ glm::vec2 World::getAtlasNormalizedTileSize() const {
     std::cerr << "Error: TextureManager not initialized in World when getAtlasNormalizedTileSize was called." << std::endl;
     return glm::vec2(0.0f); // Should not happen if constructor order is correct
 }
+
+int World::getAtlasTilesPerRow() const {
+    return m_textureManager ? m_textureManager->getTilesPerRow() : 1;
+}
+
+void World::setMeshingMode(MeshingMode mode) { m_meshingMode = mode; }
+MeshingMode World::getMeshingMode() const { return m_meshingMode; }
+
+MeshingStats World::consumeMeshingStats()
+{
+    MeshingStats stats;
+    stats.chunkCount = m_meshedChunkCount.exchange(0);
+    stats.totalMilliseconds = static_cast<double>(m_meshingTimeNs.exchange(0)) / 1.0e6;
+    return stats;
+}
@@ -2,7 +2,6 @@
 
 #include <vector>
 #include <memory>
-#include <map>
 #include <cmath>
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/glm.hpp> // Required for glm::vec2
@@ -11,98 +10,161 @@
 #include <thread>
 #include <atomic>
 #include <deque>
-#include <unordered_map>
+#include <array>
+#include <type_traits>
 
 #include "Chunk.hpp"
+#include "ChunkMap.hpp"
+#include "ChunkGrid.hpp"
 #include "Shader.hpp"
 #include "Block.hpp"
-#include "TerrainGenerator.hpp"
+#include "GpuTerrainGenerator.hpp"
+#include "CpuTerrainGenerator.hpp"
 #include "ChunkRenderer.hpp"
+#include "ChunkRegionTree.hpp"
 #include "ThreadSafeQueue.hpp"
+#include "ChunkRequestQueue.hpp"
 #include "Constants.hpp"
 #include "TextureManager.hpp" 
 
 class Camera;
 
-// Custom comparator for glm::ivec3 to allow its use as a key in std::map.
-struct ivec3_comp
-{
-    bool operator()(const glm::ivec3 &a, const glm::ivec3 &b) const
-    {
-        return std::lexicographical_compare(glm::value_ptr(a), glm::value_ptr(a) + 3, glm::value_ptr(b), glm::value_ptr(b) + 3);
-    }
-};
-
-// Custom hash function for glm::ivec3 to use in unordered_map.
-struct ivec3_hash {
-    std::size_t operator()(const glm::ivec3& v) const {
-        std::size_t seed = 0;
-        std::hash<int> hasher;
-        seed ^= hasher(v.x) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-        seed ^= hasher(v.y) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-        seed ^= hasher(v.z) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-        return seed;
-    }
+// A unit of work for the CPU worker threads.
+struct WorkerTask {
+    enum class Type {
+        MESH,           // Mesh the loaded chunk at chunkCoord
+        BUILD_CHUNK,    // Create the chunk at chunkCoord from its generated blocks in the readback ring
+        GENERATE_CHUNK  // Generate the chunk at chunkCoord with the CPU terrain generator
+    };
+    Type type = Type::MESH;
+    glm::ivec3 chunkCoord{0};
+    // BUILD_CHUNK only: keeps the readback ring slot alive, and the chunk's index in the batch.
+    std::shared_ptr<ReadbackLease> readback;
+    size_t batchIndex = 0;
 };
 
-// The lifecycle state of a chunk.
-enum class ChunkState {
-    UNDEFINED,            // Not yet processed, or unloaded
-    BACKLOG,              // In the queue for GPU generation
-    GPU_PENDING,          // Compute job sent to GPU
-    PBO_PENDING,          // PBO readback scheduled
-    DATA_READY,           // Data is ready, needs meshing
-    MESH_PENDING,         // Sent to CPU worker for meshing
-    READY                 // Meshed and ready to be rendered
+// Meshing throughput accumulated by the worker threads, used to compare meshing modes.
+struct MeshingStats {
+    uint32_t chunkCount = 0;
+    double totalMilliseconds = 0.0;
 };
 
+// The container holding the world's chunks, selected at compile time.
+using ChunkStore = std::conditional_t<Constants::USE_CHUNK_RING_BUFFER, ChunkGrid, ChunkMap>;
 
 class World
 {
 private:
-    std::map<glm::ivec3, std::shared_ptr<Chunk>, ivec3_comp> m_chunks;
-    std::unordered_map<glm::ivec3, ChunkState, ivec3_hash> m_chunkStates;
+    // Every chunk the world knows about, from BACKLOG to READY, with its lifecycle state.
+    ChunkStore m_chunks;
     mutable std::mutex m_worldDataMutex;
 
     // The player's render distance, in chunks.
     int m_renderDistance = Constants::RENDER_DISTANCE;
     glm::ivec3 m_lastPlayerChunkCoord;
+    glm::vec3 m_lastViewDirection{0.0f};
+
+    // Turning further than this (~10 degrees) since the last update re-prioritizes queued chunk requests.
+    static constexpr float VIEW_RESCORE_COS = 0.985f;
 
     std::unique_ptr<ChunkRenderer> m_chunkRenderer;
-    std::unique_ptr<TerrainGenerator> m_terrainGenerator;
+    // The chunks with meshes that are culled on the CPU: those with a transparent mesh, plus those with
+    // an opaque one when GPU culling is unavailable. Only touched on the main thread, and only kept when
+    // occlusion culling is off: rendering then walks it instead of collectReachableChunks.
+    ChunkRegionTree m_cpuCulledChunks;
+    // The occlusion walk's grid of the chunks around the camera (see collectReachableChunks). Cells are
+    // cleared lazily: a cell stamped with an older epoch than the current walk's holds nothing.
+    struct ReachCell {
+        uint32_t epoch = 0;
+        uint8_t flags = 0;
+        uint16_t connectivity = 0;
+    };
+    std::vector<ReachCell> m_reachGrid;
+    uint32_t m_reachEpoch = 0;
+    // The cull slots of the opaque meshes the walk reached, as a bitmask for ChunkRenderer::drawCulled.
+    std::vector<uint32_t> m_visibleCullSlots;
+    // Always present, and declared first so it outlives the GPU generator, which reads its heightmap cache.
+    std::unique_ptr<CpuTerrainGenerator> m_cpuTerrainGenerator;
+    // Null when GPU generation is disabled or unavailable.
+    std::unique_ptr<GpuTerrainGenerator> m_gpuTerrainGenerator;
     std::unique_ptr<TextureManager> m_textureManager; 
 
     // --- GPU Job Management ---
     std::list<GpuJob> m_pendingGpuJobs;
-    std::list<PboReadJob> m_pendingPboReads;
+    std::list<ReadbackJob> m_pendingReadbacks;
+    // Chunks queued for or being generated on the worker threads.
+    std::atomic<int> m_cpuGenerationsInFlight{0};
 
     // --- World Management Thread ---
     std::thread m_managementThread;
-    ThreadSafeQueue<glm::ivec3> m_managementQueue; 
-    ThreadSafeQueue<glm::ivec3> m_gpuRequestQueue; 
-    ThreadSafeQueue<glm::ivec3> m_unloadQueue;     
+    ThreadSafeQueue<PlayerView> m_managementQueue;
+    ChunkRequestQueue m_chunkRequestQueue{Constants::RENDER_DISTANCE + Constants::CHUNK_UNLOAD_MARGIN};
+    ThreadSafeQueue<std::shared_ptr<Chunk>> m_unloadQueue; // Removed chunks whose meshes still need freeing
+
+    // Sphere offsets sorted by distance, plus per single-chunk move the offsets that enter the
+    // load sphere (relative to the new centre) and leave the unload sphere (relative to the old one).
+    std::vector<glm::ivec3> m_loadOffsets;
+    std::array<std::vector<glm::ivec3>, 27> m_loadDeltas;
+    std::array<std::vector<glm::ivec3>, 27> m_unloadDeltas;
+    // The player chunk the loaded set was last built around. Owned by the management thread.
+    glm::ivec3 m_managedChunkCoord{0};
+    bool m_hasManagedChunkCoord = false;
 
     // --- CPU Meshing Pipeline ---
     std::vector<std::thread> m_workerThreads;
     std::atomic<bool> m_isShuttingDown{false};
     ThreadSafeQueue<MeshResult> m_meshResultQueue;
-    ThreadSafeQueue<glm::ivec3> m_meshRequestQueue;
+    ThreadSafeQueue<WorkerTask> m_workerQueue;
+    std::atomic<MeshingMode> m_meshingMode{MeshingMode::GREEDY};
+    std::atomic<uint32_t> m_meshedChunkCount{0};
+    std::atomic<uint64_t> m_meshingTimeNs{0};
 
     // --- Private Helper Functions ---
     void managementLoop();
     void updateChunkStates(const glm::ivec3& playerChunkCoord);
+    void resolveUniformChunks(std::vector<glm::ivec3>& coordsToLoad);
+    void buildLoadOffsets();
+    static int moveIndex(const glm::ivec3& move);
+    void unloadChunkLocked(const glm::ivec3& coord);
 
     void processUnloads();
-    void dispatchGpuJobs();
+    void dispatchGenerationJobs();
+    void claimRequests(std::vector<glm::ivec3> &coords);
+    void queueCpuGenerations(const std::vector<glm::ivec3> &coords);
     void processCompletedGpuJobs();
-    void processPboReads();
+    void processReadbacks();
+    void buildChunk(WorkerTask &task);
+    void generateChunkOnWorker(const glm::ivec3 &coord);
+    void insertGeneratedChunk(const glm::ivec3 &coord, const std::shared_ptr<Chunk> &chunk, ChunkState expectedState);
+    bool isChunkInState(const glm::ivec3 &coord, ChunkState state) const;
+    void queueMeshingLocked(const glm::ivec3 &coord, const Chunk &chunk);
     void workerLoop();
+    void collectReachableChunks(const Camera &camera, std::vector<std::shared_ptr<Chunk>> &out);
 
 public:
     World();
     ~World();
-    void update(const glm::vec3 &playerPos);
+    // Expects the camera's frustum to be up to date, as it is used to prioritize chunk loading.
+    void update(const Camera &camera);
     void render(Shader &shader, const Camera &camera);
     BlockType getBlock(const glm::ivec3 &worldBlockPos) const;
+
+    /**
+     * @brief Builds the padded block snapshot the mesher works from.
+     * @details The chunk and its six face neighbours are looked up under a single lock; the
+     *          (immutable) block data is then copied without holding it. Missing neighbours read as AIR.
+     * @param chunkCoord The coordinate of the chunk to snapshot.
+     * @param out The snapshot to fill.
+     * @return The chunk, or nullptr if it is not loaded (in which case `out` is left untouched).
+     */
+    std::shared_ptr<Chunk> buildSnapshot(const glm::ivec3 &chunkCoord, ChunkSnapshot &out) const;
     glm::vec2 getAtlasNormalizedTileSize() const;
+    int getAtlasTilesPerRow() const;
+
+    // Selects the algorithm used for chunks meshed from now on.
+    void setMeshingMode(MeshingMode mode);
+    MeshingMode getMeshingMode() const;
+
+    // Returns the meshing statistics accumulated since the last call and resets them.
+    MeshingStats consumeMeshingStats();
 };
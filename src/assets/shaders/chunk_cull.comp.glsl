@@ -0,0 +1,86 @@
+#version 460 core
+// Frustum-culls every registered opaque chunk mesh and writes the indirect draw commands of the
+// visible ones, grouped by buffer pool, for glMultiDrawElementsIndirectCount (see ChunkRenderer).
+layout (local_size_x = 64) in;
+
+const uint QUADS_PER_DRAW = 16384u; // Must match ChunkRenderer::QUADS_PER_DRAW
+const uint COMMAND_WORDS = 5u;      // uints per DrawElementsIndirectCommand
+
+// A registered mesh: its chunk's bounds and its allocation. quadCount is 0 for a free record.
+struct CullRecord {
+    vec4 boundsMin; // xyz, w unused
+    vec4 boundsMax; // xyz, w unused
+    uint poolIndex;
+    uint quadOffset;
+    uint quadCount;
+    uint padding;
+};
+
+layout(std430, binding = 0) readonly buffer CullRecordBuffer {
+    CullRecord records[];
+};
+
+// The first command of each pool's region in the command buffer.
+layout(std430, binding = 1) readonly buffer PoolCommandBaseBuffer {
+    uint poolCommandBase[];
+};
+
+// The number of commands written for each pool, read back as the draw count. Cleared by the CPU before dispatch.
+layout(std430, binding = 2) buffer DrawCountBuffer {
+    uint drawCounts[];
+};
+
+// DrawElementsIndirectCommand { count, instanceCount, firstIndex, baseVertex, baseInstance }, tightly packed.
+layout(std430, binding = 3) writeonly buffer CommandBuffer {
+    uint commands[];
+};
+
+// With u_useVisibleSlots, bit i % 32 of word i / 32 must be set for record i to be drawn (see World::render).
+layout(std430, binding = 4) readonly buffer VisibleSlotBuffer {
+    uint visibleSlots[];
+};
+
+uniform uint u_recordCount;
+uniform bool u_useVisibleSlots;
+// The frustum planes (xyz normal pointing inwards, w distance), from Camera::updateFrustum.
+uniform vec4 u_frustumPlanes[6];
+
+// The same test as Camera::isAABBVisible: outside if the corner furthest along a plane's normal is behind it.
+bool isVisible(vec3 boundsMin, vec3 boundsMax)
+{
+    for (int i = 0; i < 6; ++i)
+    {
+        vec4 plane = u_frustumPlanes[i];
+        vec3 pVertex = mix(boundsMin, boundsMax, greaterThan(plane.xyz, vec3(0.0)));
+        if (dot(plane.xyz, pVertex) + plane.w < 0.0)
+            return false;
+    }
+    return true;
+}
+
+void main()
+{
+    uint recordIndex = gl_GlobalInvocationID.x;
+    if (recordIndex >= u_recordCount)
+        return;
+
+    if (u_useVisibleSlots && (visibleSlots[recordIndex >> 5] & (1u << (recordIndex & 31u))) == 0u)
+        return;
+
+    CullRecord record = records[recordIndex];
+    if (record.quadCount == 0u || !isVisible(record.boundsMin.xyz, record.boundsMax.xyz))
+        return;
+
+    // A mesh larger than the shared index pattern takes several commands, like in ChunkRenderer::queueDraw.
+    uint commandCount = (record.quadCount + QUADS_PER_DRAW - 1u) / QUADS_PER_DRAW;
+    uint command = poolCommandBase[record.poolIndex] + atomicAdd(drawCounts[record.poolIndex], commandCount);
+    for (uint first = 0u; first < record.quadCount; first += QUADS_PER_DRAW, ++command)
+    {
+        uint word = command * COMMAND_WORDS;
+        commands[word + 0u] = min(record.quadCount - first, QUADS_PER_DRAW) * 6u;
+        commands[word + 1u] = 1u;
+        commands[word + 2u] = 0u;
+        commands[word + 3u] = (record.quadOffset + first) * 4u; // baseVertex, never negative
+        commands[word + 4u] = recordIndex;                      // baseInstance: the record's chunk origin
+    }
+}
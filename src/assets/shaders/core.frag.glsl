@@ -10,7 +10,6 @@ struct Material {
 
 // Input variables from the vertex shader
 in vec3 vs_position;
-in vec4 vs_color;
 in vec3 vs_normal;
 in vec2 vs_atlasOffset;   // Tile origin in atlas (Tx, Ty) - EXACT TOP-LEFT
 in vec2 vs_surfaceCoords; // Surface repetition coords (s, t)
@@ -66,6 +65,6 @@ void main() {
         vec3 specularFinal = material.specular * specularStrength;
 
         vec3 lighting = ambientFinal + diffuseFinal + specularFinal;
-        fs_color = vec4(lighting * textureColor.rgb * vs_color.rgb, outputAlpha);
+        fs_color = vec4(lighting * textureColor.rgb, outputAlpha);
     }
 }
@@ -1,33 +1,67 @@
 #version 460 core
 
-// Input vertex attributes
-layout (location = 0) in vec3 a_position;    // local position (0-16)
-layout (location = 1) in vec4 a_color;       // vertex color for tinting
-layout (location = 2) in vec3 a_normal;      // face normal
-layout (location = 3) in vec2 a_atlasOffset; // UV of tile's origin in atlas (Tx, Ty)
-layout (location = 4) in vec2 a_surfaceCoords; // Surface coords for repetition (s, t)
+// The chunk mesh quads (see Quad.hpp), read directly instead of through vertex attributes:
+//   x: origin x, y, z (5 bits each, 0-16) | face (3 bits) | size along u - 1, size along v - 1 (4 bits each)
+//   y: atlas tile index (16 bits)
+// Every quad is drawn as the four vertices 4 * quad + corner (the base vertex is the mesh's first
+// quad times 4), indexed by a static pattern shared by all meshes (see ChunkRenderer).
+layout(std430, binding = 3) readonly buffer QuadBuffer {
+    uvec2 quads[];
+};
+
+// The world-space origin (xyz) of the chunk of each draw in a multi-draw, indexed by its base instance.
+layout(std430, binding = 4) readonly buffer ChunkOriginBuffer {
+    vec4 chunkOrigins[];
+};
 
 // Output variables for the fragment shader
 out vec3 vs_position;
-out vec4 vs_color;
 out vec3 vs_normal;
-out vec2 vs_atlasOffset;   // Pass through Tx, Ty
-out vec2 vs_surfaceCoords; // Pass through s, t
+out vec2 vs_atlasOffset;   // UV of tile's origin in atlas (Tx, Ty)
+out vec2 vs_surfaceCoords; // Surface coords for repetition (s, t)
 
 // Uniforms
-uniform mat4 ModelMatrix;
 uniform mat4 ViewMatrix;
 uniform mat4 ProjectionMatrix;
+uniform vec2 u_atlasTileSize;  // Normalized size of one tile in the atlas
+uniform int u_atlasTilesPerRow; // Tile i sits at column i % u_atlasTilesPerRow, row i / u_atlasTilesPerRow
+
+// The face normals, indexed by axis * 2 + (positive ? 1 : 0).
+const vec3 FACE_NORMALS[6] = vec3[6](
+    vec3(-1.0, 0.0, 0.0), vec3(1.0, 0.0, 0.0),
+    vec3(0.0, -1.0, 0.0), vec3(0.0, 1.0, 0.0),
+    vec3(0.0, 0.0, -1.0), vec3(0.0, 0.0, 1.0));
 
 void main() {
-    vec3 vertex_position = a_position;
+    uvec2 quad = quads[gl_VertexID >> 2];
+    uint corner = uint(gl_VertexID) & 3u;
+    uint geometry = quad.x;
+    uint face = (geometry >> 15) & 7u;
+    uint axis = face >> 1;
+    uint sizeU = ((geometry >> 18) & 15u) + 1u;
+    uint sizeV = ((geometry >> 22) & 15u) + 1u;
+    uint tile = quad.y & 0xFFFFu;
+    uint tilesPerRow = uint(u_atlasTilesPerRow);
+
+    // Negative faces swap corners 1 and 3, which reverses the winding of the shared index pattern.
+    if ((face & 1u) == 0u && (corner & 1u) == 1u)
+        corner ^= 2u;
+    // Steps along the face's u axis (the next axis after it) and v axis (the one after that).
+    uint stepU = (corner == 1u || corner == 2u) ? 1u : 0u;
+    uint stepV = corner >> 1;
+
+    vec3 vertex_position = vec3(geometry & 31u, (geometry >> 5) & 31u, (geometry >> 10) & 31u);
+    vertex_position[(axis + 1u) % 3u] += float(stepU * sizeU);
+    vertex_position[(axis + 2u) % 3u] += float(stepV * sizeV);
 
-    vs_position = vec4(ModelMatrix * vec4(vertex_position, 1.0f)).xyz;
-    vs_color = a_color;
-    vs_normal = normalize(mat3(transpose(inverse(ModelMatrix))) * a_normal);
+    vs_position = chunkOrigins[gl_BaseInstance].xyz + vertex_position;
+    vs_normal = FACE_NORMALS[face];
     
-    vs_atlasOffset = a_atlasOffset;
-    vs_surfaceCoords = a_surfaceCoords;
+    vs_atlasOffset = vec2(tile % tilesPerRow, tile / tilesPerRow) * u_atlasTileSize;
+    // The texture repeats once per block. For X faces (u = Y, v = Z) and Y faces (u = Z, v = X)
+    // the surface coordinates run (v, u); for Z faces (u = X, v = Y) they run (u, v).
+    vec2 surfaceCoords = vec2(stepU * sizeU, stepV * sizeV);
+    vs_surfaceCoords = (axis == 2u) ? surfaceCoords : surfaceCoords.yx;
     
     gl_Position = ProjectionMatrix * ViewMatrix * vec4(vs_position, 1.0f);
 }
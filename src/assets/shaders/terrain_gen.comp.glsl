@@ -1,60 +1,230 @@
 #version 460 core
-layout (local_size_x = 8, local_size_y = 8, local_size_z = 8) in;
+// Each invocation generates BLOCKS_PER_WORD consecutive blocks along z, so a workgroup still covers 8x8x8 blocks.
+layout (local_size_x = 8, local_size_y = 8, local_size_z = 2) in;
 
 // Constants
 const int CHUNK_DIM = 16;
+const int CHUNK_VOL = CHUNK_DIM * CHUNK_DIM * CHUNK_DIM;
+const int BLOCKS_PER_WORD = 4;
+const int WORDS_PER_CHUNK = CHUNK_VOL / BLOCKS_PER_WORD;
+const uvec3 GROUP_BLOCKS = uvec3(8, 8, 8);
+const uint GROUPS_PER_AXIS = uint(CHUNK_DIM / 8);
+const int MAX_BATCH_SIZE = 64; // Must match GpuTerrainGenerator::MAX_BATCH_SIZE
 const uint AIR = 0u;
 const uint DIRT = 1u;
 const uint GRASS = 2u;
 const uint STONE = 3u;
 
-// The buffer to store the generated block data.
-// It's a 1D array representing the 3D chunk volume.
+// The buffer to store the generated block data of every chunk in the batch.
 layout(std430, binding = 0) buffer BlockBuffer {
+    // Per chunk, the bitset of the block IDs present in it (bit n = ID n). Cleared by the CPU before dispatch.
+    uint presentTypes[MAX_BATCH_SIZE];
+    // The chunk volumes back to back, each a 1D array representing the 3D volume with
+    // four 8-bit block IDs per uint (block index i in byte i % 4), i.e. plain bytes in index order.
     uint blocks[];
 };
 
-// Uniforms
-uniform ivec3 u_chunkCoord; // The coordinate of the chunk being generated.
+// The coordinates of the chunks in the batch (w unused).
+layout(std430, binding = 1) readonly buffer ChunkCoordBuffer {
+    ivec4 chunkCoords[];
+};
+
+// The surface heights of each chunk's column, CHUNK_DIM * CHUNK_DIM per chunk indexed [x][z].
+// Computed (and cached per column) on the CPU, so every chunk stacked in a column reuses them.
+layout(std430, binding = 2) readonly buffer ColumnHeightBuffer {
+    int columnHeights[];
+};
+
+// Per-workgroup accumulation of presentTypes, so only one global atomic is issued per workgroup.
+shared uint s_presentTypes;
+
+// The world seed.
+uniform uint u_seed;
+
+// Terrain shape. Must match TerrainGenerator (the CPU reference), which the functions below mirror
+// operation for operation; `precise` keeps the compiler from reordering or fusing them, so both
+// produce identical blocks.
+const int DIRT_DEPTH = 3;
+const int OVERHANG_HEIGHT = 10;
+const float OVERHANG_FREQUENCY = 0.0625;
+const float OVERHANG_THRESHOLD = 0.4;
+const float OVERHANG_FALLOFF = 0.06;
+const int OVERHANG_SEED_LAYER = 16;
+const int CAVE_DEPTH = 40;
+const float CAVE_FREQUENCY = 0.03125;
+const float CAVE_RADIUS = 0.1;
+const int CAVE_SEED_LAYER = 17;
+
+uint hash(ivec3 p, uint seed) {
+    uint h = seed ^ (uint(p.x) * 0x8da6b343u) ^ (uint(p.y) * 0xd8163841u) ^ (uint(p.z) * 0xcb1ab31fu);
+    h ^= h >> 16;
+    h *= 0x7feb352du;
+    h ^= h >> 15;
+    h *= 0x846ca68bu;
+    h ^= h >> 16;
+    return h;
+}
+
+uint octaveSeed(uint seed, int octave) {
+    return seed + uint(octave) * 0x9e3779b9u;
+}
+
+float grad3(uint h, float dx, float dy, float dz) {
+    h &= 15u;
+    float u = h < 8u ? dx : dy;
+    float v = h < 4u ? dy : (h == 12u || h == 14u) ? dx : dz;
+    precise float result = ((h & 1u) != 0u ? -u : u) + ((h & 2u) != 0u ? -v : v);
+    return result;
+}
+
+float fade(float t) {
+    precise float result = t * t * t * (t * (t * 6.0 - 15.0) + 10.0);
+    return result;
+}
+
+float lerpNoise(float a, float b, float t) {
+    precise float result = a + t * (b - a);
+    return result;
+}
+
+// 3D gradient noise with Perlin's twelve edge gradients.
+float gradientNoise3D(vec3 p, uint seed) {
+    vec3 p0 = floor(p);
+    ivec3 i = ivec3(p0);
+    precise vec3 f = p - p0;
+    precise vec3 f1 = f - vec3(1.0);
+
+    float n000 = grad3(hash(i, seed), f.x, f.y, f.z);
+    float n100 = grad3(hash(i + ivec3(1, 0, 0), seed), f1.x, f.y, f.z);
+    float n010 = grad3(hash(i + ivec3(0, 1, 0), seed), f.x, f1.y, f.z);
+    float n110 = grad3(hash(i + ivec3(1, 1, 0), seed), f1.x, f1.y, f.z);
+    float n001 = grad3(hash(i + ivec3(0, 0, 1), seed), f.x, f.y, f1.z);
+    float n101 = grad3(hash(i + ivec3(1, 0, 1), seed), f1.x, f.y, f1.z);
+    float n011 = grad3(hash(i + ivec3(0, 1, 1), seed), f.x, f1.y, f1.z);
+    float n111 = grad3(hash(i + ivec3(1, 1, 1), seed), f1.x, f1.y, f1.z);
+
+    float u = fade(f.x);
+    float v = fade(f.y);
+    float w = fade(f.z);
+    float nx00 = lerpNoise(n000, n100, u);
+    float nx10 = lerpNoise(n010, n110, u);
+    float nx01 = lerpNoise(n001, n101, u);
+    float nx11 = lerpNoise(n011, n111, u);
+    return lerpNoise(lerpNoise(nx00, nx10, v), lerpNoise(nx01, nx11, v), w);
+}
+
+// The 3D noise fields are sampled every DENSITY_LATTICE_SPACING blocks and trilinearly interpolated.
+// Each workgroup samples the lattice points of its 8^3 blocks once into shared memory; points on the
+// workgroup's faces are sampled again by its neighbours, which yields the very same values.
+const int DENSITY_LATTICE_SPACING = 4;
+const float DENSITY_LATTICE_STEP = 0.25; // 1 / DENSITY_LATTICE_SPACING
+const int GROUP_LATTICE_DIM = 8 / DENSITY_LATTICE_SPACING + 1;
+const int GROUP_LATTICE_POINTS = GROUP_LATTICE_DIM * GROUP_LATTICE_DIM * GROUP_LATTICE_DIM;
+const int DENSITY_FIELDS = 3; // The overhang field, then the two cave fields
+shared float s_density[DENSITY_FIELDS][GROUP_LATTICE_POINTS];
+
+// A 3D noise field at a lattice point (in lattice units).
+float latticeSample(ivec3 latticePos, float frequency, uint seed) {
+    // Sampled half a block off the lattice point, never on a noise lattice point (where gradient noise is always zero).
+    precise vec3 p = (vec3(latticePos * DENSITY_LATTICE_SPACING) + 0.5) * frequency;
+    return gradientNoise3D(p, seed);
+}
+
+// A density field at a block, interpolated from the workgroup's lattice; groupPos is the block's position in the workgroup.
+float latticeDensity(int field, ivec3 groupPos) {
+    ivec3 l = groupPos / DENSITY_LATTICE_SPACING;
+    vec3 t = vec3(groupPos & (DENSITY_LATTICE_SPACING - 1)) * DENSITY_LATTICE_STEP;
+    int base = (l.x * GROUP_LATTICE_DIM + l.y) * GROUP_LATTICE_DIM + l.z;
+    const int dx = GROUP_LATTICE_DIM * GROUP_LATTICE_DIM;
+    const int dy = GROUP_LATTICE_DIM;
+    float x00 = lerpNoise(s_density[field][base], s_density[field][base + dx], t.x);
+    float x10 = lerpNoise(s_density[field][base + dy], s_density[field][base + dx + dy], t.x);
+    float x01 = lerpNoise(s_density[field][base + 1], s_density[field][base + dx + 1], t.x);
+    float x11 = lerpNoise(s_density[field][base + dy + 1], s_density[field][base + dx + dy + 1], t.x);
+    return lerpNoise(lerpNoise(x00, x10, t.y), lerpNoise(x01, x11, t.y), t.z);
+}
+
+// Rock above the surface where the density exceeds a threshold rising with the height.
+bool isOverhang(float density, int heightAboveSurface) {
+    precise float threshold = OVERHANG_THRESHOLD + float(heightAboveSurface) * OVERHANG_FALLOFF;
+    return density > threshold;
+}
+
+// Tunnels where the two cave fields are both near zero.
+bool isCave(float caveA, float caveB) {
+    return abs(caveA) < CAVE_RADIUS && abs(caveB) < CAVE_RADIUS;
+}
+
+// The block at height worldY in a column whose surface is at surfaceY, before any 3D shaping.
+uint blockAt(int worldY, int surfaceY) {
+    if (worldY > surfaceY) {
+        return AIR;
+    } else if (worldY == surfaceY) {
+        return GRASS;
+    } else if (worldY > surfaceY - DIRT_DEPTH - 1) { // DIRT_DEPTH layers of dirt
+        return DIRT;
+    }
+    return STONE; // Everything below is stone
+}
+
+// Returns the block ID at a chunk-local position of chunk `chunkIndex` in the batch.
+uint generateBlock(uint chunkIndex, ivec3 chunkCoord, ivec3 localPos, ivec3 groupPos) {
+    int surfaceY = columnHeights[int(chunkIndex) * CHUNK_DIM * CHUNK_DIM + localPos.x * CHUNK_DIM + localPos.z];
+    ivec3 worldPos = chunkCoord * CHUNK_DIM + localPos;
+
+    // Only a band around the surface is shaped by the 3D density: overhangs above it, caves below.
+    if (worldPos.y <= surfaceY - CAVE_DEPTH || worldPos.y > surfaceY + OVERHANG_HEIGHT) {
+        return blockAt(worldPos.y, surfaceY);
+    }
+    if (worldPos.y > surfaceY) {
+        return isOverhang(latticeDensity(0, groupPos), worldPos.y - surfaceY) ? STONE : AIR;
+    }
+    return isCave(latticeDensity(1, groupPos), latticeDensity(2, groupPos)) ? AIR : blockAt(worldPos.y, surfaceY);
+}
 
 void main() {
-    // Get the 3D local coordinate of this thread within the work group.
-    ivec3 localPos = ivec3(gl_GlobalInvocationID);
+    // Workgroups are stacked along z, GROUPS_PER_AXIS per chunk; a workgroup never spans two chunks.
+    uint chunkIndex = gl_WorkGroupID.z / GROUPS_PER_AXIS;
+    uvec3 groupInChunk = uvec3(gl_WorkGroupID.xy, gl_WorkGroupID.z % GROUPS_PER_AXIS);
+    ivec3 groupPos = ivec3(gl_LocalInvocationID * uvec3(1, 1, BLOCKS_PER_WORD));
+    ivec3 localPos = ivec3(groupInChunk * GROUP_BLOCKS) + groupPos;
+    ivec3 chunkCoord = chunkCoords[chunkIndex].xyz;
+
+    if (gl_LocalInvocationIndex == 0u) {
+        s_presentTypes = 0u;
+    }
+    // Sample the workgroup's density lattice, one lattice point of one field per invocation.
+    int field = int(gl_LocalInvocationIndex) / GROUP_LATTICE_POINTS;
+    if (field < DENSITY_FIELDS) {
+        int point = int(gl_LocalInvocationIndex) % GROUP_LATTICE_POINTS;
+        ivec3 corner = ivec3(point / (GROUP_LATTICE_DIM * GROUP_LATTICE_DIM), (point / GROUP_LATTICE_DIM) % GROUP_LATTICE_DIM, point % GROUP_LATTICE_DIM);
+        ivec3 latticePos = (chunkCoord * CHUNK_DIM + ivec3(groupInChunk * GROUP_BLOCKS)) / DENSITY_LATTICE_SPACING + corner;
+        s_density[field][point] = field == 0
+            ? latticeSample(latticePos, OVERHANG_FREQUENCY, octaveSeed(u_seed, OVERHANG_SEED_LAYER))
+            : latticeSample(latticePos, CAVE_FREQUENCY, octaveSeed(u_seed, CAVE_SEED_LAYER + field - 1));
+    }
+    barrier();
 
     // Make sure we're not trying to write outside the chunk's boundaries.
-    if (any(greaterThanEqual(localPos, ivec3(CHUNK_DIM)))) {
-        return;
+    // (No early return: every invocation has to reach the barriers below.)
+    if (all(lessThan(localPos, ivec3(CHUNK_DIM)))) {
+        // Generate BLOCKS_PER_WORD blocks along z and pack them into one word, lowest byte first.
+        uint packedIDs = 0u;
+        uint types = 0u;
+        for (int i = 0; i < BLOCKS_PER_WORD; ++i) {
+            uint blockID = generateBlock(chunkIndex, chunkCoord, localPos + ivec3(0, 0, i), groupPos + ivec3(0, 0, i));
+            packedIDs |= blockID << (8 * i);
+            types |= 1u << blockID;
+        }
+
+        // The 1D block index (x-major) of the first block, divided by BLOCKS_PER_WORD.
+        int index = localPos.x * CHUNK_DIM * CHUNK_DIM + localPos.y * CHUNK_DIM + localPos.z;
+        blocks[chunkIndex * WORDS_PER_CHUNK + index / BLOCKS_PER_WORD] = packedIDs;
+        atomicOr(s_presentTypes, types);
     }
+    barrier();
 
-    // Calculate the 1D index for the `blocks` buffer from the 3D local position.
-    uint index = localPos.x * CHUNK_DIM * CHUNK_DIM + localPos.y * CHUNK_DIM + localPos.z;
-
-    // Calculate the world coordinate of the block. We use the center for noise sampling.
-    ivec3 worldBlockCoord_minCorner = u_chunkCoord * CHUNK_DIM + localPos;
-    float worldX_center = float(worldBlockCoord_minCorner.x) + 0.5f;
-    int   worldY_block  = worldBlockCoord_minCorner.y; 
-    float worldZ_center = float(worldBlockCoord_minCorner.z) + 0.5f;
-
-    // Determine the terrain height at this X, Z position using a simple noise function.
-    // This creates a basic, rolling-hills landscape.
-    float amplitude = 100.0f;
-    float frequency = 0.1f;
-    int base_height_block_y = 0;
-    // Combine sine and cosine to create a more varied pattern than a simple wave.
-    int terrain_surface_y = base_height_block_y + int(amplitude * (sin(worldX_center * frequency) + cos(worldZ_center * frequency)) / 2.0f);
-
-    // Determine the block type based on its height relative to the surface.
-    uint blockID;
-    if (worldY_block > terrain_surface_y) {
-        blockID = AIR;
-    } else if (worldY_block == terrain_surface_y) {
-        blockID = GRASS;
-    } else if (worldY_block > terrain_surface_y - 4) { // 3 layers of dirt
-        blockID = DIRT;
-    } else { // Everything below is stone
-        blockID = STONE;
+    if (gl_LocalInvocationIndex == 0u) {
+        atomicOr(presentTypes[chunkIndex], s_presentTypes);
     }
-    
-    // Write the final block ID to the buffer.
-    blocks[index] = blockID;
 }
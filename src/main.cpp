@@ -5,10 +5,171 @@
 #include "Camera.hpp"
 #include "EmbeddedShaders.hpp"
 #include "Constants.hpp" // Required for Constants::TEXTURE_SIZE_PX
+#include "CpuTerrainGenerator.hpp"
+#include "GpuTerrainGenerator.hpp"
 #include <glm/gtc/matrix_transform.hpp>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+#include <thread>
 
-int main()
+// Generates `chunkCount` chunks headless on every hardware thread with the CPU terrain generator
+// and reports the throughput. Needs no window or OpenGL context.
+static int benchTerrain(int chunkCount)
 {
+    CpuTerrainGenerator generator;
+    const unsigned threadCount = std::max(1u, std::thread::hardware_concurrency());
+    std::cout << "Generating " << chunkCount << " chunks on " << threadCount << " threads ("
+              << generator.getSimdPathName() << ")" << std::endl;
+
+    std::atomic<int> nextChunk{0};
+    std::atomic<uint64_t> checksum{0};
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < threadCount; t++)
+    {
+        threads.emplace_back([&]()
+        {
+            BlockType blocks[Constants::CHUNK_VOL];
+            uint64_t localSum = 0;
+            for (int i = nextChunk++; i < chunkCount; i = nextChunk++)
+            {
+                // Walk a square area around the origin, a few chunks deep around the surface.
+                const int side = 64;
+                const glm::ivec3 coord(i % side - side / 2, (i / side) % 8 - 4, (i / (side * 8)) - side / 2);
+                localSum += generator.generateChunk(coord, blocks) + static_cast<uint64_t>(blocks[i % Constants::CHUNK_VOL]);
+            }
+            checksum += localSum;
+        });
+    }
+    for (auto &thread : threads)
+        thread.join();
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Generated in " << seconds * 1000.0 << " ms: " << static_cast<int>(chunkCount / seconds)
+              << " chunks/s (checksum " << checksum << ")" << std::endl;
+    return 0;
+}
+
+// Frustum-tests `boxCount` chunk AABBs around the camera with isAABBVisible and with every path of the
+// batched areAABBsVisible, checks that they agree and reports the time per pass. Needs no window or OpenGL context.
+static int benchFrustum(int boxCount)
+{
+    // Chunk-sized boxes scattered through a cube around the camera, looking along a diagonal.
+    const glm::vec3 eye(0.0f, 64.0f, 0.0f);
+    Camera camera(eye, 1920, 1080, glm::vec3(0.0f, 1.0f, 0.0f), 30.0f, -10.0f);
+    camera.updateFrustum(camera.getViewMatrix());
+
+    std::vector<float> bounds[6];
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<int> chunkCoord(-64, 63);
+    for (int i = 0; i < boxCount; i++)
+    {
+        const glm::vec3 min = eye + glm::vec3(chunkCoord(rng), chunkCoord(rng) / 4, chunkCoord(rng)) * Constants::CHUNK_WIDTH;
+        for (int axis = 0; axis < 3; axis++)
+        {
+            bounds[axis].push_back(min[axis]);
+            bounds[3 + axis].push_back(min[axis] + Constants::CHUNK_WIDTH);
+        }
+    }
+    const AABBArrays boxes{bounds[0].data(), bounds[1].data(), bounds[2].data(), bounds[3].data(), bounds[4].data(), bounds[5].data()};
+    const size_t words = (static_cast<size_t>(boxCount) + 63) / 64;
+    constexpr int passes = 50;
+
+    // The best of several passes, in milliseconds.
+    auto timePasses = [&](auto &&pass)
+    {
+        double best = std::numeric_limits<double>::max();
+        for (int i = 0; i < passes; i++)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            pass();
+            best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+        return best;
+    };
+
+    std::vector<uint64_t> reference(words, 0);
+    const double scalarMs = timePasses([&]()
+    {
+        for (int i = 0; i < boxCount; i++)
+        {
+            const bool visible = camera.isAABBVisible({boxes.minX[i], boxes.minY[i], boxes.minZ[i]}, {boxes.maxX[i], boxes.maxY[i], boxes.maxZ[i]});
+            reference[i / 64] = (reference[i / 64] & ~(uint64_t{1} << (i % 64))) | (static_cast<uint64_t>(visible) << (i % 64));
+        }
+    });
+    size_t visibleCount = 0;
+    for (uint64_t word : reference)
+        visibleCount += std::popcount(word);
+    std::cout << "Frustum test of " << boxCount << " boxes (" << visibleCount << " visible)" << std::endl;
+    std::cout << "  isAABBVisible: " << scalarMs << " ms" << std::endl;
+
+    bool agree = true;
+    for (Camera::SimdPath path : {Camera::SimdPath::SCALAR, Camera::SimdPath::SSE2, Camera::SimdPath::AVX2})
+    {
+        Camera batchCamera = camera;
+        batchCamera.setSimdPath(path);
+        if (batchCamera.getSimdPath() != path)
+            continue; // Not supported by this CPU
+
+        std::vector<uint64_t> mask(words);
+        const double batchMs = timePasses([&]() { batchCamera.areAABBsVisible(boxes, boxCount, mask.data()); });
+        const bool matches = mask == reference;
+        agree = agree && matches;
+        std::cout << "  areAABBsVisible (" << batchCamera.getSimdPathName() << "): " << batchMs << " ms, "
+                  << scalarMs / batchMs << "x" << (matches ? "" : " MISMATCH") << std::endl;
+    }
+    return agree ? 0 : 1;
+}
+
+// Generates `chunkCount` chunks around the surface with both the GPU and the CPU generator and
+// compares them block by block. Needs the OpenGL context of an initialized window.
+static int verifyTerrain(int chunkCount)
+{
+    CpuTerrainGenerator cpuGenerator;
+    GpuTerrainGenerator gpuGenerator(EmbeddedShaders::terrain_gen_comp, cpuGenerator.getHeightmapCache(), cpuGenerator.getSeed());
+
+    std::vector<BlockType> cpuBlocks(Constants::CHUNK_VOL), gpuBlocks(Constants::CHUNK_VOL);
+    int mismatchedChunks = 0;
+    for (int i = 0; i < chunkCount; i++)
+    {
+        const glm::ivec3 coord(i % 61 - 30, i % 11 - 6, (i / 61) % 61 - 30);
+        const uint32_t cpuTypes = cpuGenerator.generateChunk(coord, cpuBlocks.data());
+        const uint32_t gpuTypes = gpuGenerator.generateChunk(coord, gpuBlocks.data());
+        if (cpuTypes == gpuTypes && cpuBlocks == gpuBlocks)
+            continue;
+
+        if (mismatchedChunks++ == 0)
+        {
+            std::cerr << "First mismatch in chunk (" << coord.x << ", " << coord.y << ", " << coord.z << ")";
+            const auto mismatch = std::mismatch(cpuBlocks.begin(), cpuBlocks.end(), gpuBlocks.begin());
+            if (mismatch.first != cpuBlocks.end())
+            {
+                const int index = static_cast<int>(mismatch.first - cpuBlocks.begin());
+                std::cerr << " at block " << index << ": CPU " << static_cast<int>(*mismatch.first) << ", GPU " << static_cast<int>(*mismatch.second) << std::endl;
+            }
+            else
+            {
+                // Same blocks, but a different set of present types was reported.
+                std::cerr << " in the present types: CPU 0x" << std::hex << cpuTypes << ", GPU 0x" << gpuTypes << std::dec << std::endl;
+            }
+        }
+    }
+    std::cout << "Terrain verification: " << mismatchedChunks << " of " << chunkCount << " chunks differ" << std::endl;
+    return mismatchedChunks == 0 ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc >= 2 && std::strcmp(argv[1], "--bench-terrain") == 0)
+        return benchTerrain(argc >= 3 ? std::stoi(argv[2]) : 100000);
+    if (argc >= 2 && std::strcmp(argv[1], "--bench-frustum") == 0)
+        return benchFrustum(argc >= 3 ? std::stoi(argv[2]) : 200000);
+
     // Frame timing
     float deltaTime = 0.0f;
     float lastFrame = 0.0f;
@@ -35,6 +196,9 @@ int main()
     std::cout << "OpenGL Version: " << glGetString(GL_VERSION) << std::endl;
     std::cout << "GLSL Version: " << glGetString(GL_SHADING_LANGUAGE_VERSION) << std::endl;
 
+    if (argc >= 2 && std::strcmp(argv[1], "--verify-terrain") == 0)
+        return verifyTerrain(argc >= 3 ? std::stoi(argv[2]) : 2000);
+
     // OpenGL settings
     glEnable(GL_DEPTH_TEST);
     glEnable(GL_CULL_FACE);
@@ -57,6 +221,7 @@ int main()
     } else {
         std::cerr << "Warning: Atlas tile size is zero in main. Textures might not render correctly." << std::endl;
     }
+    coreShader.setInt("u_atlasTilesPerRow", world.getAtlasTilesPerRow());
     coreShader.setFloat("u_texturePixelDimension", static_cast<float>(Constants::TEXTURE_SIZE_PX));
 
 
@@ -78,15 +243,24 @@ int main()
             double actual_interval = currentFrame - lastFrameTime;
             int fps = static_cast<int>(frameCount / actual_interval);
             std::cout << "FPS: " << fps << std::endl;
+
+            MeshingStats meshingStats = world.consumeMeshingStats();
+            if (meshingStats.chunkCount > 0)
+            {
+                std::cout << "Meshing (" << (world.getMeshingMode() == MeshingMode::BINARY ? "binary" : "greedy") << "): "
+                          << meshingStats.chunkCount << " chunks, "
+                          << (meshingStats.totalMilliseconds * 1000.0 / meshingStats.chunkCount) << " us/chunk" << std::endl;
+            }
             frameCount = 0;
             lastFrameTime = currentFrame;
         }
 
         window.updateInput(deltaTime);
-        world.update(camera.getPosition());
+        world.setMeshingMode(window.isBinaryMeshingEnabled() ? MeshingMode::BINARY : MeshingMode::GREEDY);
 
         glm::mat4 ViewMatrix = camera.getViewMatrix();
         camera.updateFrustum(ViewMatrix);
+        world.update(camera);
 
         glClearColor(0.1f, 0.4f, 0.7f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);